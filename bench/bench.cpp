@@ -0,0 +1,783 @@
+#include <benchmark/benchmark.h>
+#include <bit_matrix.hpp>
+#include <bitset.hpp>
+#include <bitset_array.hpp>
+#include <bitset_parallel.hpp>
+#include <bitset_view.hpp>
+#include <hierarchical_bitset.hpp>
+#include <rank_select.hpp>
+#include <roaring_bitset.hpp>
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+template <class Bits> Bits make_random(std::uint64_t seed) {
+    std::mt19937_64 gen(seed);
+    Bits bits;
+    for (std::size_t i = 0; i < bits.size(); i++) {
+        bits[i] = (gen() & 1) != 0;
+    }
+    return bits;
+}
+
+template <class Bits> void BM_construct_ullong(benchmark::State &state) {
+    unsigned long long value{0x0123456789abcdefull};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(value);
+        Bits bits(value);
+        benchmark::DoNotOptimize(bits);
+    }
+}
+
+template <class Bits> void BM_construct_string(benchmark::State &state) {
+    const std::string str = make_random<Bits>(1).to_string();
+    for (auto _ : state) {
+        Bits bits(str);
+        benchmark::DoNotOptimize(bits);
+    }
+}
+
+template <class Bits> void BM_set_all(benchmark::State &state) {
+    Bits bits;
+    for (auto _ : state) {
+        bits.set();
+        benchmark::DoNotOptimize(bits);
+    }
+}
+
+template <class Bits> void BM_set_pos(benchmark::State &state) {
+    Bits bits;
+    std::size_t pos{0};
+    for (auto _ : state) {
+        bits.set(pos);
+        benchmark::DoNotOptimize(bits);
+        pos = pos + 1 == bits.size() ? 0 : pos + 1;
+    }
+}
+
+template <class Bits> void BM_reset_all(benchmark::State &state) {
+    Bits bits = make_random<Bits>(1);
+    for (auto _ : state) {
+        bits.reset();
+        benchmark::DoNotOptimize(bits);
+    }
+}
+
+template <class Bits> void BM_reset_pos(benchmark::State &state) {
+    Bits bits = make_random<Bits>(1);
+    std::size_t pos{0};
+    for (auto _ : state) {
+        bits.reset(pos);
+        benchmark::DoNotOptimize(bits);
+        pos = pos + 1 == bits.size() ? 0 : pos + 1;
+    }
+}
+
+template <class Bits> void BM_flip_all(benchmark::State &state) {
+    Bits bits = make_random<Bits>(1);
+    for (auto _ : state) {
+        bits.flip();
+        benchmark::DoNotOptimize(bits);
+    }
+}
+
+template <class Bits> void BM_flip_pos(benchmark::State &state) {
+    Bits bits = make_random<Bits>(1);
+    std::size_t pos{0};
+    for (auto _ : state) {
+        bits.flip(pos);
+        benchmark::DoNotOptimize(bits);
+        pos = pos + 1 == bits.size() ? 0 : pos + 1;
+    }
+}
+
+template <class Bits> void BM_test(benchmark::State &state) {
+    const Bits bits = make_random<Bits>(1);
+    std::size_t pos{0};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bits.test(pos));
+        pos = pos + 1 == bits.size() ? 0 : pos + 1;
+    }
+}
+
+template <class Bits> void BM_subscript(benchmark::State &state) {
+    const Bits bits = make_random<Bits>(1);
+    std::size_t pos{0};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bits[pos]);
+        pos = pos + 1 == bits.size() ? 0 : pos + 1;
+    }
+}
+
+template <class Bits> void BM_count(benchmark::State &state) {
+    Bits bits = make_random<Bits>(1);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bits);
+        benchmark::DoNotOptimize(bits.count());
+    }
+}
+
+template <class Bits> void BM_all(benchmark::State &state) {
+    Bits bits;
+    bits.set();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bits);
+        benchmark::DoNotOptimize(bits.all());
+    }
+}
+
+template <class Bits> void BM_any(benchmark::State &state) {
+    Bits bits;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bits);
+        benchmark::DoNotOptimize(bits.any());
+    }
+}
+
+template <class Bits> void BM_none(benchmark::State &state) {
+    Bits bits;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bits);
+        benchmark::DoNotOptimize(bits.none());
+    }
+}
+
+template <class Bits> void BM_and_assign(benchmark::State &state) {
+    Bits lhs = make_random<Bits>(1);
+    const Bits rhs = make_random<Bits>(2);
+    for (auto _ : state) {
+        lhs &= rhs;
+        benchmark::DoNotOptimize(lhs);
+    }
+}
+
+template <class Bits> void BM_or_assign(benchmark::State &state) {
+    Bits lhs = make_random<Bits>(1);
+    const Bits rhs = make_random<Bits>(2);
+    for (auto _ : state) {
+        lhs |= rhs;
+        benchmark::DoNotOptimize(lhs);
+    }
+}
+
+template <class Bits> void BM_xor_assign(benchmark::State &state) {
+    Bits lhs = make_random<Bits>(1);
+    const Bits rhs = make_random<Bits>(2);
+    for (auto _ : state) {
+        lhs ^= rhs;
+        benchmark::DoNotOptimize(lhs);
+    }
+}
+
+template <class Bits> void BM_and(benchmark::State &state) {
+    Bits lhs = make_random<Bits>(1);
+    Bits rhs = make_random<Bits>(2);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(lhs);
+        benchmark::DoNotOptimize(rhs);
+        Bits result = lhs & rhs;
+        benchmark::DoNotOptimize(result);
+    }
+}
+
+template <class Bits> void BM_or(benchmark::State &state) {
+    Bits lhs = make_random<Bits>(1);
+    Bits rhs = make_random<Bits>(2);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(lhs);
+        benchmark::DoNotOptimize(rhs);
+        Bits result = lhs | rhs;
+        benchmark::DoNotOptimize(result);
+    }
+}
+
+template <class Bits> void BM_xor(benchmark::State &state) {
+    Bits lhs = make_random<Bits>(1);
+    Bits rhs = make_random<Bits>(2);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(lhs);
+        benchmark::DoNotOptimize(rhs);
+        Bits result = lhs ^ rhs;
+        benchmark::DoNotOptimize(result);
+    }
+}
+
+template <class Bits> void BM_not(benchmark::State &state) {
+    Bits bits = make_random<Bits>(1);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bits);
+        Bits result = ~bits;
+        benchmark::DoNotOptimize(result);
+    }
+}
+
+template <class Bits> void BM_fused(benchmark::State &state) {
+    Bits a = make_random<Bits>(1);
+    Bits b = make_random<Bits>(2);
+    Bits c = make_random<Bits>(3);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        benchmark::DoNotOptimize(b);
+        benchmark::DoNotOptimize(c);
+        Bits result = (a & b) | ~c;
+        benchmark::DoNotOptimize(result);
+    }
+}
+
+template <class Bits> void BM_and_count(benchmark::State &state) {
+    Bits lhs = make_random<Bits>(1);
+    Bits rhs = make_random<Bits>(2);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(lhs);
+        benchmark::DoNotOptimize(rhs);
+        benchmark::DoNotOptimize((lhs & rhs).count());
+    }
+}
+
+template <class Bits> void BM_xor_count(benchmark::State &state) {
+    Bits lhs = make_random<Bits>(1);
+    Bits rhs = make_random<Bits>(2);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(lhs);
+        benchmark::DoNotOptimize(rhs);
+        benchmark::DoNotOptimize((lhs ^ rhs).count());
+    }
+}
+
+template <class Bits> void BM_intersects(benchmark::State &state) {
+    // Disjoint, so that every word is looked at
+    Bits lhs = make_random<Bits>(1);
+    Bits rhs = ~lhs;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(lhs);
+        benchmark::DoNotOptimize(rhs);
+        benchmark::DoNotOptimize((lhs & rhs).any());
+    }
+}
+
+template <class Bits> void BM_shift_left(benchmark::State &state) {
+    Bits bits = make_random<Bits>(1);
+    const std::size_t shift = bits.size() / 3 + 1;
+    for (auto _ : state) {
+        bits <<= shift;
+        benchmark::DoNotOptimize(bits);
+    }
+}
+
+template <class Bits> void BM_shift_right(benchmark::State &state) {
+    Bits bits = make_random<Bits>(1);
+    const std::size_t shift = bits.size() / 3 + 1;
+    for (auto _ : state) {
+        bits >>= shift;
+        benchmark::DoNotOptimize(bits);
+    }
+}
+
+// std::bitset has no rotate, so it is spelled with two shifts
+template <std::size_t N>
+void rotate_left(std::bitset<N> &bits, std::size_t shift) {
+    bits = bits << shift | bits >> (N - shift);
+}
+
+template <std::size_t N, typename Underlying>
+void rotate_left(nonstd::bitset<N, Underlying> &bits, std::size_t shift) {
+    bits.rotl(shift);
+}
+
+template <class Bits> void BM_rotl(benchmark::State &state) {
+    Bits bits = make_random<Bits>(1);
+    const std::size_t shift = bits.size() / 3 + 1;
+    for (auto _ : state) {
+        rotate_left(bits, shift);
+        benchmark::DoNotOptimize(bits);
+    }
+}
+
+template <class Bits> void BM_equal(benchmark::State &state) {
+    Bits lhs = make_random<Bits>(1);
+    Bits rhs = lhs;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(lhs);
+        benchmark::DoNotOptimize(rhs);
+        benchmark::DoNotOptimize(lhs == rhs);
+    }
+}
+
+template <class Bits> void BM_to_string(benchmark::State &state) {
+    const Bits bits = make_random<Bits>(1);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bits.to_string());
+    }
+}
+
+template <class Bits> void BM_to_ullong(benchmark::State &state) {
+    Bits bits(0x0123456789abcdefull);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bits);
+        benchmark::DoNotOptimize(bits.to_ullong());
+    }
+}
+
+template <class Bits> void BM_hash(benchmark::State &state) {
+    Bits bits = make_random<Bits>(1);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bits);
+        benchmark::DoNotOptimize(std::hash<Bits>()(bits));
+    }
+}
+
+template <class Bits> void BM_stream_insert(benchmark::State &state) {
+    const Bits bits = make_random<Bits>(1);
+    std::ostringstream os;
+    for (auto _ : state) {
+        os.str(std::string());
+        os << bits;
+        benchmark::DoNotOptimize(os);
+    }
+}
+
+template <class Bits> void BM_stream_extract(benchmark::State &state) {
+    const std::string str = make_random<Bits>(1).to_string();
+    Bits bits;
+    for (auto _ : state) {
+        std::istringstream is(str);
+        is >> bits;
+        benchmark::DoNotOptimize(bits);
+    }
+}
+
+// Walks the set bits of a huge bitset with one bit set in every 2^16
+template <class Bits> void BM_sparse_find(benchmark::State &state) {
+    auto bits = std::make_unique<Bits>();
+    for (std::size_t i = 12345; i < bits->size(); i += 65536) {
+        bits->set(i);
+    }
+    for (auto _ : state) {
+        std::size_t found{0};
+        for (auto pos = bits->find_first(); pos < bits->size();
+             pos = bits->find_next(pos)) {
+            found++;
+        }
+        benchmark::DoNotOptimize(found);
+    }
+}
+
+// Intersects two huge bitsets with a few thousand scattered bits each
+template <class Bits> void BM_sparse_and_count(benchmark::State &state) {
+    auto lhs = std::make_unique<Bits>();
+    auto rhs = std::make_unique<Bits>();
+    std::mt19937_64 gen(1);
+    for (int i = 0; i < 4096; i++) {
+        lhs->set(gen() % (std::size_t{1} << 24));
+        rhs->set(gen() % (std::size_t{1} << 24));
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(lhs->intersection_count(*rhs));
+    }
+}
+
+// Ranks by counting a shifted copy, for comparison with BM_rank
+template <class Bits> void BM_rank_by_shift(benchmark::State &state) {
+    const auto bits = std::make_unique<Bits>(make_random<Bits>(1));
+    std::size_t pos{12345};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize((*bits << (bits->size() - pos)).count());
+        pos = (pos * 7 + 1) % bits->size();
+    }
+}
+
+template <class Bits> void BM_rank(benchmark::State &state) {
+    const auto bits = std::make_unique<Bits>(make_random<Bits>(1));
+    const nonstd::rank_select<Bits().size(), std::uint64_t> index(*bits);
+    std::size_t pos{12345};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(index.rank(pos));
+        pos = (pos * 7 + 1) % bits->size();
+    }
+}
+
+template <class Bits> void BM_select(benchmark::State &state) {
+    const auto bits = std::make_unique<Bits>(make_random<Bits>(1));
+    const nonstd::rank_select<Bits().size(), std::uint64_t> index(*bits);
+    std::size_t k{12345};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(index.select(k));
+        k = (k * 7 + 1) % index.count();
+    }
+}
+
+// Sets a run of bits one at a time, for comparison with BM_set_range
+template <class Bits> void BM_set_range_by_bit(benchmark::State &state) {
+    constexpr std::size_t kLen{1000};
+    const auto bits = std::make_unique<Bits>();
+    std::size_t pos{12345};
+    for (auto _ : state) {
+        for (std::size_t i = pos; i < pos + kLen; i++) {
+            bits->set(i);
+        }
+        benchmark::DoNotOptimize(*bits);
+        pos = (pos * 7 + 1) % (bits->size() - kLen);
+    }
+}
+
+template <class Bits> void BM_set_range(benchmark::State &state) {
+    constexpr std::size_t kLen{1000};
+    const auto bits = std::make_unique<Bits>();
+    std::size_t pos{12345};
+    for (auto _ : state) {
+        bits->set(pos, kLen, true);
+        benchmark::DoNotOptimize(*bits);
+        pos = (pos * 7 + 1) % (bits->size() - kLen);
+    }
+}
+
+template <class Bits> void BM_count_range(benchmark::State &state) {
+    constexpr std::size_t kLen{1000};
+    const auto bits = std::make_unique<Bits>(make_random<Bits>(1));
+    std::size_t pos{12345};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bits->count(pos, kLen));
+        pos = (pos * 7 + 1) % (bits->size() - kLen);
+    }
+}
+
+// Reads a 13-bit field by shifting a copy, for comparison with BM_extract
+template <class Bits> void BM_extract_by_shift(benchmark::State &state) {
+    const auto bits = make_random<Bits>(1);
+    std::size_t pos{123};
+    for (auto _ : state) {
+        const Bits field = (bits >> pos) & Bits(0x1fff);
+        benchmark::DoNotOptimize(field.to_ullong());
+        pos = (pos * 7 + 1) % (bits.size() - 13);
+    }
+}
+
+template <class Bits> void BM_extract(benchmark::State &state) {
+    const auto bits = make_random<Bits>(1);
+    std::size_t pos{123};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bits.extract(pos, 13));
+        pos = (pos * 7 + 1) % (bits.size() - 13);
+    }
+}
+
+// Counts the bits of words in external memory, e.g. a mapped file, by
+// copying them into a bitset first
+template <class Bits> void BM_mapped_count_copy(benchmark::State &state) {
+    const auto bits = std::make_unique<Bits>(make_random<Bits>(1));
+    std::vector<std::byte> memory(bits->byte_size());
+    bits->write_to(memory.data());
+    auto copy = std::make_unique<Bits>();
+    for (auto _ : state) {
+        copy->read_from(memory.data());
+        benchmark::DoNotOptimize(copy->count());
+    }
+}
+
+// The same, counting the words in place through a view
+template <class Bits> void BM_mapped_count_view(benchmark::State &state) {
+    using view_t = nonstd::const_bitset_view<Bits().size(), std::uint64_t>;
+    const auto bits = std::make_unique<Bits>(make_random<Bits>(1));
+    std::vector<std::uint64_t> memory(view_t::num_words());
+    bits->write_to(reinterpret_cast<std::byte *>(memory.data()));
+    const view_t view(memory.data());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(view.count());
+    }
+}
+
+// ANDs 2^20 rows of 256 bits with a mask and counts every result, one
+// bitset at a time
+void BM_rows_and_count_vector(benchmark::State &state) {
+    using bits_t = nonstd::bitset<256, std::uint64_t>;
+    std::vector<bits_t> rows;
+    for (std::uint64_t i = 0; i < (1u << 20); i++) {
+        rows.push_back(make_random<bits_t>(i));
+    }
+    const auto mask = make_random<bits_t>(0);
+    std::vector<std::size_t> counts(rows.size());
+    for (auto _ : state) {
+        for (std::size_t r = 0; r < rows.size(); r++) {
+            counts[r] = rows[r].intersection_count(mask);
+        }
+        benchmark::DoNotOptimize(counts.data());
+    }
+}
+
+// The same with the rows stored column by column
+void BM_rows_and_count_array(benchmark::State &state) {
+    using bits_t = nonstd::bitset<256, std::uint64_t>;
+    nonstd::bitset_array<256, std::uint64_t> rows;
+    for (std::uint64_t i = 0; i < (1u << 20); i++) {
+        rows.push_back(make_random<bits_t>(i));
+    }
+    const auto mask = make_random<bits_t>(0);
+    std::vector<std::size_t> counts(rows.size());
+    for (auto _ : state) {
+        rows.and_count_all(mask, counts.data());
+        benchmark::DoNotOptimize(counts.data());
+    }
+}
+
+// Transposes a 1024x1024 matrix stored as an array of bitsets, one bit at a
+// time
+void BM_transpose_array(benchmark::State &state) {
+    using row_t = nonstd::bitset<1024, std::uint64_t>;
+    using matrix_t = std::array<row_t, 1024>;
+    auto matrix = std::make_unique<matrix_t>();
+    auto result = std::make_unique<matrix_t>();
+    for (std::size_t r = 0; r < matrix->size(); r++) {
+        (*matrix)[r] = make_random<row_t>(r);
+    }
+    for (auto _ : state) {
+        for (std::size_t r = 0; r < 1024; r++) {
+            for (std::size_t c = 0; c < 1024; c++) {
+                (*result)[c][r] = (*matrix)[r][c];
+            }
+        }
+        benchmark::DoNotOptimize(result->data());
+    }
+}
+
+// The same with a bit_matrix, 64x64 bits at a time
+void BM_transpose_matrix(benchmark::State &state) {
+    using row_t = nonstd::bitset<1024, std::uint64_t>;
+    using matrix_t = nonstd::bit_matrix<1024, 1024, std::uint64_t>;
+    auto matrix = std::make_unique<matrix_t>();
+    auto result = std::make_unique<matrix_t>();
+    for (std::size_t r = 0; r < matrix->rows(); r++) {
+        matrix->row(r) = make_random<row_t>(r);
+    }
+    for (auto _ : state) {
+        *result = matrix->transpose();
+        benchmark::DoNotOptimize(result.get());
+    }
+}
+
+// Multiplies two 1024x1024 matrices over GF(2)
+void BM_matrix_multiply(benchmark::State &state) {
+    using row_t = nonstd::bitset<1024, std::uint64_t>;
+    using matrix_t = nonstd::bit_matrix<1024, 1024, std::uint64_t>;
+    auto lhs = std::make_unique<matrix_t>();
+    auto rhs = std::make_unique<matrix_t>();
+    auto result = std::make_unique<matrix_t>();
+    for (std::size_t r = 0; r < lhs->rows(); r++) {
+        lhs->row(r) = make_random<row_t>(r);
+        rhs->row(r) = make_random<row_t>(r + lhs->rows());
+    }
+    for (auto _ : state) {
+        *result = *lhs * *rhs;
+        benchmark::DoNotOptimize(result.get());
+    }
+}
+
+// A heap-allocated bitset of 2^28 bits (32 MiB), filled with random bytes
+using huge_bits_t = nonstd::bitset<std::size_t{1} << 28, std::uint64_t>;
+
+std::unique_ptr<huge_bits_t> make_huge(std::uint64_t seed) {
+    std::mt19937_64 gen(seed);
+    std::vector<std::byte> bytes(huge_bits_t::byte_size());
+    for (std::size_t i = 0; i < bytes.size(); i += 8) {
+        const auto word = gen();
+        std::memcpy(&bytes[i], &word, sizeof word);
+    }
+    auto bits = std::make_unique<huge_bits_t>();
+    bits->read_from(bytes.data());
+    return bits;
+}
+
+void BM_huge_count_serial(benchmark::State &state) {
+    const auto bits = make_huge(1);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bits->count());
+    }
+}
+
+void BM_huge_count_parallel(benchmark::State &state) {
+    nonstd::thread_pool pool;
+    const auto bits = make_huge(1);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(nonstd::parallel::count(pool, *bits));
+    }
+}
+
+void BM_huge_or_serial(benchmark::State &state) {
+    auto lhs = make_huge(1);
+    const auto rhs = make_huge(2);
+    for (auto _ : state) {
+        *lhs |= *rhs;
+        benchmark::DoNotOptimize(lhs.get());
+    }
+}
+
+void BM_huge_or_parallel(benchmark::State &state) {
+    nonstd::thread_pool pool;
+    auto lhs = make_huge(1);
+    const auto rhs = make_huge(2);
+    for (auto _ : state) {
+        nonstd::parallel::or_assign(pool, *lhs, *rhs);
+        benchmark::DoNotOptimize(lhs.get());
+    }
+}
+
+template <class Bits> void register_all(const std::string &type) {
+    using fn_t = void (*)(benchmark::State &);
+    const std::pair<const char *, fn_t> benchmarks[] = {
+        {"construct_ullong", BM_construct_ullong<Bits>},
+        {"construct_string", BM_construct_string<Bits>},
+        {"set_all", BM_set_all<Bits>},
+        {"set_pos", BM_set_pos<Bits>},
+        {"reset_all", BM_reset_all<Bits>},
+        {"reset_pos", BM_reset_pos<Bits>},
+        {"flip_all", BM_flip_all<Bits>},
+        {"flip_pos", BM_flip_pos<Bits>},
+        {"test", BM_test<Bits>},
+        {"subscript", BM_subscript<Bits>},
+        {"count", BM_count<Bits>},
+        {"all", BM_all<Bits>},
+        {"any", BM_any<Bits>},
+        {"none", BM_none<Bits>},
+        {"and_assign", BM_and_assign<Bits>},
+        {"or_assign", BM_or_assign<Bits>},
+        {"xor_assign", BM_xor_assign<Bits>},
+        {"and", BM_and<Bits>},
+        {"or", BM_or<Bits>},
+        {"xor", BM_xor<Bits>},
+        {"not", BM_not<Bits>},
+        {"fused", BM_fused<Bits>},
+        {"and_count", BM_and_count<Bits>},
+        {"xor_count", BM_xor_count<Bits>},
+        {"intersects", BM_intersects<Bits>},
+        {"shift_left", BM_shift_left<Bits>},
+        {"shift_right", BM_shift_right<Bits>},
+        {"rotl", BM_rotl<Bits>},
+        {"equal", BM_equal<Bits>},
+        {"to_string", BM_to_string<Bits>},
+        {"to_ullong", BM_to_ullong<Bits>},
+        {"hash", BM_hash<Bits>},
+        {"stream_insert", BM_stream_insert<Bits>},
+        {"stream_extract", BM_stream_extract<Bits>},
+    };
+    for (const auto &[op, fn] : benchmarks) {
+        // Names are "<operation>/<type>" so results can be grouped by either
+        benchmark::RegisterBenchmark((std::string(op) + "/" + type).c_str(),
+                                     fn);
+    }
+}
+
+template <std::size_t N> void register_size() {
+    const auto n = std::to_string(N);
+    register_all<std::bitset<N>>("std::bitset<" + n + ">");
+    register_all<nonstd::bitset<N, std::uint8_t>>("nonstd::bitset<" + n +
+                                                   ",uint8_t>");
+    register_all<nonstd::bitset<N, std::uint16_t>>("nonstd::bitset<" + n +
+                                                    ",uint16_t>");
+    register_all<nonstd::bitset<N, std::uint32_t>>("nonstd::bitset<" + n +
+                                                    ",uint32_t>");
+    register_all<nonstd::bitset<N, std::uint64_t>>("nonstd::bitset<" + n +
+                                                    ",uint64_t>");
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+
+    register_size<1>();
+    register_size<8>();
+    register_size<64>();
+    register_size<129>();
+    register_size<1024>();
+    register_size<65536>();
+
+    constexpr std::size_t kHuge = std::size_t{1} << 24;
+    benchmark::RegisterBenchmark(
+        "sparse_find/nonstd::bitset<16777216,uint64_t>",
+        BM_sparse_find<nonstd::bitset<kHuge, std::uint64_t>>);
+    benchmark::RegisterBenchmark(
+        "sparse_find/nonstd::hierarchical_bitset<16777216,uint64_t>",
+        BM_sparse_find<nonstd::hierarchical_bitset<kHuge, std::uint64_t>>);
+    benchmark::RegisterBenchmark(
+        "sparse_and_count/nonstd::bitset<16777216,uint64_t>",
+        BM_sparse_and_count<nonstd::bitset<kHuge, std::uint64_t>>);
+    benchmark::RegisterBenchmark("sparse_and_count/nonstd::roaring_bitset",
+                                 BM_sparse_and_count<nonstd::roaring_bitset>);
+    using rank_bits_t = nonstd::bitset<std::size_t{1} << 20, std::uint64_t>;
+    benchmark::RegisterBenchmark(
+        "rank_by_shift/nonstd::bitset<1048576,uint64_t>",
+        BM_rank_by_shift<rank_bits_t>);
+    benchmark::RegisterBenchmark("rank/nonstd::rank_select<1048576,uint64_t>",
+                                 BM_rank<rank_bits_t>);
+    benchmark::RegisterBenchmark("select/nonstd::rank_select<1048576,uint64_t>",
+                                 BM_select<rank_bits_t>);
+
+    using range_bits_t = nonstd::bitset<65536, std::uint64_t>;
+    benchmark::RegisterBenchmark(
+        "set_range_by_bit/nonstd::bitset<65536,uint64_t>",
+        BM_set_range_by_bit<range_bits_t>);
+    benchmark::RegisterBenchmark("set_range/nonstd::bitset<65536,uint64_t>",
+                                 BM_set_range<range_bits_t>);
+    benchmark::RegisterBenchmark("count_range/nonstd::bitset<65536,uint64_t>",
+                                 BM_count_range<range_bits_t>);
+
+    using header_bits_t = nonstd::bitset<512, std::uint8_t>;
+    benchmark::RegisterBenchmark("extract_by_shift/nonstd::bitset<512,uint8_t>",
+                                 BM_extract_by_shift<header_bits_t>);
+    benchmark::RegisterBenchmark("extract/nonstd::bitset<512,uint8_t>",
+                                 BM_extract<header_bits_t>);
+
+    using mapped_bits_t = nonstd::bitset<kHuge, std::uint64_t>;
+    benchmark::RegisterBenchmark(
+        "mapped_count_copy/nonstd::bitset<16777216,uint64_t>",
+        BM_mapped_count_copy<mapped_bits_t>);
+    benchmark::RegisterBenchmark(
+        "mapped_count_view/nonstd::const_bitset_view<16777216,uint64_t>",
+        BM_mapped_count_view<mapped_bits_t>);
+
+    benchmark::RegisterBenchmark(
+        "rows_and_count/std::vector<nonstd::bitset<256,uint64_t>>",
+        BM_rows_and_count_vector);
+    benchmark::RegisterBenchmark(
+        "rows_and_count/nonstd::bitset_array<256,uint64_t>",
+        BM_rows_and_count_array);
+
+    benchmark::RegisterBenchmark(
+        "transpose/std::array<nonstd::bitset<1024,uint64_t>,1024>",
+        BM_transpose_array);
+    benchmark::RegisterBenchmark(
+        "transpose/nonstd::bit_matrix<1024,1024,uint64_t>",
+        BM_transpose_matrix);
+    benchmark::RegisterBenchmark(
+        "multiply/nonstd::bit_matrix<1024,1024,uint64_t>", BM_matrix_multiply);
+
+    benchmark::RegisterBenchmark("count/nonstd::bitset<268435456,uint64_t>",
+                                 BM_huge_count_serial)
+        ->UseRealTime();
+    benchmark::RegisterBenchmark(
+        "parallel_count/nonstd::bitset<268435456,uint64_t>",
+        BM_huge_count_parallel)
+        ->UseRealTime();
+    benchmark::RegisterBenchmark(
+        "or_assign/nonstd::bitset<268435456,uint64_t>", BM_huge_or_serial)
+        ->UseRealTime();
+    benchmark::RegisterBenchmark(
+        "parallel_or_assign/nonstd::bitset<268435456,uint64_t>",
+        BM_huge_or_parallel)
+        ->UseRealTime();
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,267 @@
+#pragma once
+
+#include "bitset.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace nonstd {
+
+// A bitset whose words are std::atomic<Underlying>, for bits shared between
+// threads without a lock. Single-bit operations are atomic; operations on the
+// whole bitset (fetch_or, load, count, ...) are atomic per word only, so they
+// may observe concurrent changes to different words at different times.
+//
+// Every operation takes a memory order, which defaults to Order, or to the
+// nearest order valid for plain loads and stores. Wider words are faster to
+// scan; narrower ones make each atomic operation cover fewer bits.
+template <std::size_t N, typename Underlying = std::uint8_t,
+          std::memory_order Order = std::memory_order_seq_cst>
+class atomic_bitset {
+    static_assert(std::is_unsigned_v<Underlying>,
+                  "atomic_bitset requires an unsigned underlying type");
+    static_assert(std::atomic<Underlying>::is_always_lock_free,
+                  "atomic_bitset requires lock-free atomic words");
+
+    using underlying_type_t = Underlying;
+    using bitset_type = bitset<N, Underlying>;
+
+    static constexpr std::size_t s_num_underlying_bits =
+        8 * sizeof(underlying_type_t);
+    static constexpr std::size_t s_num_words =
+        (N + s_num_underlying_bits - 1) / s_num_underlying_bits;
+
+    static constexpr std::size_t underlying_index(std::size_t i) noexcept {
+        return i / s_num_underlying_bits;
+    }
+
+    static constexpr underlying_type_t mask(std::size_t pos) noexcept {
+        return underlying_type_t{1} << (pos % s_num_underlying_bits);
+    }
+
+    // The orders valid for plain loads and stores that come closest to a
+    // read-modify-write order
+    static constexpr std::memory_order load_order(std::memory_order order) {
+        switch (order) {
+        case std::memory_order_release:
+            return std::memory_order_relaxed;
+        case std::memory_order_acq_rel:
+            return std::memory_order_acquire;
+        default:
+            return order;
+        }
+    }
+
+    static constexpr std::memory_order store_order(std::memory_order order) {
+        switch (order) {
+        case std::memory_order_consume:
+        case std::memory_order_acquire:
+            return std::memory_order_relaxed;
+        case std::memory_order_acq_rel:
+            return std::memory_order_release;
+        default:
+            return order;
+        }
+    }
+
+    static void check_pos(std::size_t pos, const char *what) {
+        if (pos >= N) {
+            throw std::out_of_range(std::string("atomic_bitset::") + what +
+                                    ": pos out of range");
+        }
+    }
+
+    std::array<std::atomic<underlying_type_t>, s_num_words> m_data{};
+
+  public:
+    static constexpr bool is_always_lock_free = true;
+
+    atomic_bitset() noexcept = default;
+
+    explicit atomic_bitset(const bitset_type &bits) noexcept {
+        const auto &words = detail::bitset_access::words(bits);
+        for (std::size_t i = 0; i < s_num_words; i++) {
+            m_data[i].store(words[i], std::memory_order_relaxed);
+        }
+    }
+
+    atomic_bitset(const atomic_bitset &) = delete;
+    atomic_bitset &operator=(const atomic_bitset &) = delete;
+
+    constexpr std::size_t size() const noexcept { return N; }
+
+    bool operator[](std::size_t pos) const noexcept {
+        return (m_data[underlying_index(pos)].load(load_order(Order)) &
+                mask(pos)) !=
+               underlying_type_t{0};
+    }
+
+    bool test(std::size_t pos,
+              std::memory_order order = load_order(Order)) const {
+        check_pos(pos, "test");
+        return (m_data[underlying_index(pos)].load(order) & mask(pos)) !=
+               underlying_type_t{0};
+    }
+
+    // Sets the bit and returns its previous value. Exactly one of several
+    // threads racing to set a clear bit sees false.
+    bool test_and_set(std::size_t pos, std::memory_order order = Order) {
+        check_pos(pos, "test_and_set");
+        return (m_data[underlying_index(pos)].fetch_or(mask(pos), order) &
+                mask(pos)) != underlying_type_t{0};
+    }
+
+    // Clears the bit and returns its previous value
+    bool test_and_reset(std::size_t pos, std::memory_order order = Order) {
+        check_pos(pos, "test_and_reset");
+        return (m_data[underlying_index(pos)].fetch_and(
+                    static_cast<underlying_type_t>(~mask(pos)), order) &
+                mask(pos)) != underlying_type_t{0};
+    }
+
+    // Flips the bit and returns its previous value
+    bool test_and_flip(std::size_t pos, std::memory_order order = Order) {
+        check_pos(pos, "test_and_flip");
+        return (m_data[underlying_index(pos)].fetch_xor(mask(pos), order) &
+                mask(pos)) != underlying_type_t{0};
+    }
+
+    atomic_bitset &set(std::size_t pos, bool value = true,
+                       std::memory_order order = Order) {
+        if (value) {
+            test_and_set(pos, order);
+        } else {
+            test_and_reset(pos, order);
+        }
+        return *this;
+    }
+
+    atomic_bitset &reset(std::size_t pos, std::memory_order order = Order) {
+        test_and_reset(pos, order);
+        return *this;
+    }
+
+    atomic_bitset &flip(std::size_t pos, std::memory_order order = Order) {
+        test_and_flip(pos, order);
+        return *this;
+    }
+
+    // The fetch functions apply a bitset word by word and return the previous
+    // value. Words where the operation is a no-op are only loaded.
+    bitset_type fetch_or(const bitset_type &bits,
+                         std::memory_order order = Order) noexcept {
+        bitset_type previous;
+        auto &prev = detail::bitset_access::words(previous);
+        const auto &words = detail::bitset_access::words(bits);
+        for (std::size_t i = 0; i < s_num_words; i++) {
+            prev[i] = words[i] == underlying_type_t{0}
+                          ? m_data[i].load(load_order(order))
+                          : m_data[i].fetch_or(words[i], order);
+        }
+        return previous;
+    }
+
+    bitset_type fetch_and(const bitset_type &bits,
+                          std::memory_order order = Order) noexcept {
+        constexpr underlying_type_t ones = ~underlying_type_t{0};
+        bitset_type previous;
+        auto &prev = detail::bitset_access::words(previous);
+        const auto &words = detail::bitset_access::words(bits);
+        for (std::size_t i = 0; i < s_num_words; i++) {
+            prev[i] = words[i] == ones
+                          ? m_data[i].load(load_order(order))
+                          : m_data[i].fetch_and(words[i], order);
+        }
+        return previous;
+    }
+
+    bitset_type fetch_xor(const bitset_type &bits,
+                          std::memory_order order = Order) noexcept {
+        bitset_type previous;
+        auto &prev = detail::bitset_access::words(previous);
+        const auto &words = detail::bitset_access::words(bits);
+        for (std::size_t i = 0; i < s_num_words; i++) {
+            prev[i] = words[i] == underlying_type_t{0}
+                          ? m_data[i].load(load_order(order))
+                          : m_data[i].fetch_xor(words[i], order);
+        }
+        return previous;
+    }
+
+    atomic_bitset &operator|=(const bitset_type &bits) noexcept {
+        fetch_or(bits);
+        return *this;
+    }
+
+    atomic_bitset &operator&=(const bitset_type &bits) noexcept {
+        fetch_and(bits);
+        return *this;
+    }
+
+    atomic_bitset &operator^=(const bitset_type &bits) noexcept {
+        fetch_xor(bits);
+        return *this;
+    }
+
+    // A copy of the bits, loaded one word at a time
+    bitset_type
+    load(std::memory_order order = load_order(Order)) const noexcept {
+        bitset_type bits;
+        auto &words = detail::bitset_access::words(bits);
+        for (std::size_t i = 0; i < s_num_words; i++) {
+            words[i] = m_data[i].load(order);
+        }
+        return bits;
+    }
+
+    void store(const bitset_type &bits,
+               std::memory_order order = store_order(Order)) noexcept {
+        const auto &words = detail::bitset_access::words(bits);
+        for (std::size_t i = 0; i < s_num_words; i++) {
+            m_data[i].store(words[i], order);
+        }
+    }
+
+    operator bitset_type() const noexcept { return load(); }
+
+    atomic_bitset &
+    reset(std::memory_order order = store_order(Order)) noexcept {
+        for (auto &word : m_data) {
+            word.store(underlying_type_t{0}, order);
+        }
+        return *this;
+    }
+
+    // The reductions default to relaxed loads, as they are only a snapshot
+    // anyway
+    std::size_t
+    count(std::memory_order order = std::memory_order_relaxed) const noexcept {
+        std::size_t cnt{0};
+        for (const auto &word : m_data) {
+            cnt += detail::popcount(word.load(order));
+        }
+        return cnt;
+    }
+
+    bool
+    any(std::memory_order order = std::memory_order_relaxed) const noexcept {
+        for (const auto &word : m_data) {
+            if (word.load(order) != underlying_type_t{0}) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool
+    none(std::memory_order order = std::memory_order_relaxed) const noexcept {
+        return !any(order);
+    }
+};
+
+} // namespace nonstd
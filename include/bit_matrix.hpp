@@ -0,0 +1,270 @@
+#pragma once
+
+#include "bitset.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace nonstd {
+
+// A Rows x Cols matrix of bits stored as Rows bitset<Cols, Underlying> rows,
+// e.g. an adjacency or incidence matrix. Element (r, c) is bit c of row r.
+//
+// transpose() moves 64x64 blocks at a time, gathering 64 bits of 64 rows
+// into a block of words that is transposed in registers. Products are over
+// GF(2): multiplying by a vector takes the parity of popcount(row & vector),
+// and multiplying two matrices XORs rows of the right-hand side, 8 at a time
+// through a table of their 256 combinations (the method of the Four
+// Russians).
+template <std::size_t Rows, std::size_t Cols,
+          typename Underlying = std::uint8_t>
+class bit_matrix {
+    static_assert(Rows > 0 && Cols > 0, "bit_matrix requires a non-zero size");
+    static_assert(sizeof(Underlying) <= sizeof(std::uint64_t),
+                  "bit_matrix requires words of at most 64 bits");
+
+  public:
+    using row_type = bitset<Cols, Underlying>;
+
+  private:
+    static constexpr std::size_t s_num_underlying_bits = 8 * sizeof(Underlying);
+
+    std::array<row_type, Rows> m_rows{};
+
+    // The 64 bits at pos of a bitset, pos being a multiple of 64; zero past
+    // its end
+    template <std::size_t N>
+    static constexpr std::uint64_t
+    load_block_word(const bitset<N, Underlying> &bits,
+                    std::size_t pos) noexcept {
+        const auto &words = detail::bitset_access::words(bits);
+        constexpr std::size_t kWordsPerBlock = 64 / s_num_underlying_bits;
+        const std::size_t first = pos / s_num_underlying_bits;
+        std::uint64_t value{0};
+        for (std::size_t j = 0;
+             j < kWordsPerBlock && first + j < words.size(); j++) {
+            value |= static_cast<std::uint64_t>(words[first + j])
+                     << (s_num_underlying_bits * j);
+        }
+        return value;
+    }
+
+    // Replaces the 64 bits at pos of a bitset, pos being a multiple of 64.
+    // Bits of value past the end of the bitset must be zero.
+    template <std::size_t N>
+    static constexpr void store_block_word(bitset<N, Underlying> &bits,
+                                           std::size_t pos,
+                                           std::uint64_t value) noexcept {
+        auto &words = detail::bitset_access::words(bits);
+        constexpr std::size_t kWordsPerBlock = 64 / s_num_underlying_bits;
+        const std::size_t first = pos / s_num_underlying_bits;
+        for (std::size_t j = 0;
+             j < kWordsPerBlock && first + j < words.size(); j++) {
+            words[first + j] =
+                static_cast<Underlying>(value >> (s_num_underlying_bits * j));
+        }
+    }
+
+    // Transposes a 64x64 block in which bit c of block[r] is element (r, c)
+    // by swapping ever smaller off-diagonal sub-blocks: 32x32, 16x16, down
+    // to 1x1 (Hacker's Delight, 7-3)
+    static constexpr void transpose64(std::uint64_t (&block)[64]) noexcept {
+        std::uint64_t mask = 0x00000000ffffffffull;
+        for (std::size_t j = 32; j != 0; j >>= 1, mask ^= mask << j) {
+            for (std::size_t k = 0; k < 64; k = ((k | j) + 1) & ~j) {
+                const std::uint64_t t = ((block[k] >> j) ^ block[k | j]) & mask;
+                block[k] ^= t << j;
+                block[k | j] ^= t;
+            }
+        }
+    }
+
+    // The 8 bits at pos of a row, pos being a multiple of 8
+    static constexpr unsigned row_byte(const row_type &row,
+                                       std::size_t pos) noexcept {
+        const auto &words = detail::bitset_access::words(row);
+        return static_cast<unsigned>(
+                   words[pos / s_num_underlying_bits] >>
+                   (pos % s_num_underlying_bits)) &
+               0xffu;
+    }
+
+    void check_pos(std::size_t r, std::size_t c, const char *what) const {
+        if (r >= Rows || c >= Cols) {
+            throw std::out_of_range(
+                std::string("bit_matrix::") + what + ": (" +
+                std::to_string(r) + ", " + std::to_string(c) +
+                ") out of range");
+        }
+    }
+
+    template <std::size_t, std::size_t, typename> friend class bit_matrix;
+
+  public:
+    constexpr bit_matrix() noexcept = default;
+
+    static constexpr bit_matrix identity() noexcept {
+        static_assert(Rows == Cols, "identity() requires a square matrix");
+        bit_matrix result;
+        for (std::size_t i = 0; i < Rows; i++) {
+            result.m_rows[i][i] = true;
+        }
+        return result;
+    }
+
+    static constexpr std::size_t rows() noexcept { return Rows; }
+    static constexpr std::size_t cols() noexcept { return Cols; }
+
+    constexpr row_type &row(std::size_t r) noexcept { return m_rows[r]; }
+    constexpr const row_type &row(std::size_t r) const noexcept {
+        return m_rows[r];
+    }
+
+    constexpr bool operator()(std::size_t r, std::size_t c) const noexcept {
+        return m_rows[r][c];
+    }
+
+    bool test(std::size_t r, std::size_t c) const {
+        check_pos(r, c, "test");
+        return m_rows[r][c];
+    }
+
+    bit_matrix &set(std::size_t r, std::size_t c, bool value = true) {
+        check_pos(r, c, "set");
+        m_rows[r][c] = value;
+        return *this;
+    }
+
+    bit_matrix &reset(std::size_t r, std::size_t c) {
+        return set(r, c, false);
+    }
+
+    bit_matrix &flip(std::size_t r, std::size_t c) {
+        check_pos(r, c, "flip");
+        m_rows[r].flip(c);
+        return *this;
+    }
+
+    constexpr std::size_t count() const noexcept {
+        std::size_t cnt{0};
+        for (const auto &row : m_rows) {
+            cnt += row.count();
+        }
+        return cnt;
+    }
+
+    constexpr bit_matrix<Cols, Rows, Underlying> transpose() const noexcept {
+        bit_matrix<Cols, Rows, Underlying> result;
+        std::uint64_t block[64]{};
+        for (std::size_t rb = 0; rb < Rows; rb += 64) {
+            for (std::size_t cb = 0; cb < Cols; cb += 64) {
+                for (std::size_t i = 0; i < 64; i++) {
+                    block[i] = rb + i < Rows
+                                   ? load_block_word(m_rows[rb + i], cb)
+                                   : 0;
+                }
+                transpose64(block);
+                for (std::size_t i = 0; i < 64 && cb + i < Cols; i++) {
+                    store_block_word(result.m_rows[cb + i], rb, block[i]);
+                }
+            }
+        }
+        return result;
+    }
+
+    // Element-wise, i.e. row by row
+    constexpr bit_matrix &operator&=(const bit_matrix &other) noexcept {
+        for (std::size_t r = 0; r < Rows; r++) {
+            m_rows[r] &= other.m_rows[r];
+        }
+        return *this;
+    }
+
+    constexpr bit_matrix &operator|=(const bit_matrix &other) noexcept {
+        for (std::size_t r = 0; r < Rows; r++) {
+            m_rows[r] |= other.m_rows[r];
+        }
+        return *this;
+    }
+
+    // Also the sum over GF(2)
+    constexpr bit_matrix &operator^=(const bit_matrix &other) noexcept {
+        for (std::size_t r = 0; r < Rows; r++) {
+            m_rows[r] ^= other.m_rows[r];
+        }
+        return *this;
+    }
+
+    friend constexpr bit_matrix operator&(bit_matrix lhs,
+                                          const bit_matrix &rhs) noexcept {
+        return lhs &= rhs;
+    }
+
+    friend constexpr bit_matrix operator|(bit_matrix lhs,
+                                          const bit_matrix &rhs) noexcept {
+        return lhs |= rhs;
+    }
+
+    friend constexpr bit_matrix operator^(bit_matrix lhs,
+                                          const bit_matrix &rhs) noexcept {
+        return lhs ^= rhs;
+    }
+
+    constexpr bool operator==(const bit_matrix &other) const noexcept {
+        for (std::size_t r = 0; r < Rows; r++) {
+            if (m_rows[r] != other.m_rows[r]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    constexpr bool operator!=(const bit_matrix &other) const noexcept {
+        return !(*this == other);
+    }
+
+    // The product over GF(2): bit r of the result is the parity of
+    // row(r) & vector
+    constexpr bitset<Rows, Underlying>
+    operator*(const row_type &vector) const noexcept {
+        bitset<Rows, Underlying> result;
+        for (std::size_t r = 0; r < Rows; r++) {
+            result[r] = (m_rows[r].intersection_count(vector) & 1) != 0;
+        }
+        return result;
+    }
+
+    // The product over GF(2). Row r of the result is the XOR of the rows k of
+    // rhs for which (r, k) is set; rhs is taken 8 rows at a time, XORing the
+    // precomputed combination selected by each byte of row r.
+    template <std::size_t K>
+    bit_matrix<Rows, K, Underlying>
+    operator*(const bit_matrix<Cols, K, Underlying> &rhs) const {
+        using rhs_row_t = bitset<K, Underlying>;
+        bit_matrix<Rows, K, Underlying> result;
+        std::vector<rhs_row_t> table(256);
+        for (std::size_t g = 0; g < Cols; g += 8) {
+            // table[x] is the XOR of the rows g + i of rhs for the bits i of
+            // x, built from the table entry without the lowest bit of x
+            for (std::size_t x = 1; x < 256; x++) {
+                const std::size_t i = detail::countr_zero(x);
+                table[x] = table[x & (x - 1)];
+                if (g + i < Cols) {
+                    table[x] ^= rhs.m_rows[g + i];
+                }
+            }
+            for (std::size_t r = 0; r < Rows; r++) {
+                if (const unsigned x = row_byte(m_rows[r], g); x != 0) {
+                    result.m_rows[r] ^= table[x];
+                }
+            }
+        }
+        return result;
+    }
+};
+
+} // namespace nonstd
@@ -0,0 +1,218 @@
+#pragma once
+
+#include "bitset.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+namespace nonstd {
+
+// Hands out the slot numbers 0 to N - 1, e.g. for connection or buffer ids.
+// Slot i is bit i % bits of word i / bits, as in bitset; a set bit means the
+// slot is in use. allocate() finds a free slot by counting the trailing zeros
+// of an inverted word and returns size() when every slot is taken.
+//
+// With Concurrent, any number of threads may allocate and deallocate at once:
+// a slot is claimed with a compare-and-swap on its word, and every thread
+// starts searching from its own word so that they do not all contend for the
+// first one. That starting word is kept per thread, and is shared by all
+// allocators of the same specialization that the thread uses. Otherwise the
+// words are plain integers and the object must not be shared between threads.
+//
+// Underlying defaults to 64-bit words, unlike bitset, so that each
+// compare-and-swap covers 64 slots; allocated() still returns a bitset<N>.
+template <std::size_t N, typename Underlying = std::uint64_t,
+          bool Concurrent = true>
+class bitmap_allocator {
+    static_assert(N > 0, "bitmap_allocator requires at least one slot");
+    static_assert(std::is_unsigned_v<Underlying>,
+                  "bitmap_allocator requires an unsigned underlying type");
+    static_assert(!Concurrent || std::atomic<Underlying>::is_always_lock_free,
+                  "bitmap_allocator requires lock-free atomic words");
+
+    using underlying_type_t = Underlying;
+    using word_type = std::conditional_t<Concurrent,
+                                         std::atomic<underlying_type_t>,
+                                         underlying_type_t>;
+
+    static constexpr std::size_t s_num_underlying_bits =
+        8 * sizeof(underlying_type_t);
+    static constexpr std::size_t s_num_words =
+        (N + s_num_underlying_bits - 1) / s_num_underlying_bits;
+
+    static constexpr std::size_t underlying_index(std::size_t i) noexcept {
+        return i / s_num_underlying_bits;
+    }
+
+    static constexpr underlying_type_t mask(std::size_t pos) noexcept {
+        return underlying_type_t{1} << (pos % s_num_underlying_bits);
+    }
+
+    // The bits of the last word past N are kept set, so that they are never
+    // handed out
+    static constexpr underlying_type_t s_padding =
+        N % s_num_underlying_bits == 0
+            ? underlying_type_t{0}
+            : static_cast<underlying_type_t>(
+                  underlying_type_t(~underlying_type_t{0})
+                  << (N % s_num_underlying_bits));
+
+    std::array<word_type, s_num_words> m_data{};
+    std::size_t m_hint{0};
+
+    underlying_type_t load(std::size_t i) const noexcept {
+        if constexpr (Concurrent) {
+            return m_data[i].load(std::memory_order_relaxed);
+        } else {
+            return m_data[i];
+        }
+    }
+
+    // The word to start searching from, see bitmap_allocator
+    std::size_t &hint() noexcept {
+        if constexpr (Concurrent) {
+            thread_local std::size_t t_hint =
+                std::hash<std::thread::id>()(std::this_thread::get_id()) %
+                s_num_words;
+            return t_hint;
+        } else {
+            return m_hint;
+        }
+    }
+
+    // Claims a free bit of word i, returning its slot or size() if the word
+    // is full
+    std::size_t claim_in(std::size_t i) noexcept {
+        constexpr underlying_type_t full = ~underlying_type_t{0};
+        underlying_type_t word = load(i);
+        while (word != full) {
+            const auto pos = detail::countr_zero(
+                static_cast<underlying_type_t>(~word));
+            const auto claimed =
+                static_cast<underlying_type_t>(word | mask(pos));
+            if constexpr (Concurrent) {
+                // On failure word is reloaded and the search repeated
+                if (m_data[i].compare_exchange_weak(
+                        word, claimed, std::memory_order_acquire,
+                        std::memory_order_relaxed)) {
+                    return i * s_num_underlying_bits + pos;
+                }
+            } else {
+                m_data[i] = claimed;
+                return i * s_num_underlying_bits + pos;
+            }
+        }
+        return N;
+    }
+
+    static void check_slot(std::size_t slot, const char *what) {
+        if (slot >= N) {
+            throw std::out_of_range(std::string("bitmap_allocator::") + what +
+                                    ": slot out of range");
+        }
+    }
+
+  public:
+    bitmap_allocator() noexcept {
+        if constexpr (s_padding != underlying_type_t{0}) {
+            if constexpr (Concurrent) {
+                m_data[s_num_words - 1].store(s_padding,
+                                              std::memory_order_relaxed);
+            } else {
+                m_data[s_num_words - 1] = s_padding;
+            }
+        }
+    }
+
+    bitmap_allocator(const bitmap_allocator &) = delete;
+    bitmap_allocator &operator=(const bitmap_allocator &) = delete;
+
+    constexpr std::size_t size() const noexcept { return N; }
+
+    // Claims the free slot and returns it, or returns size() if all slots are
+    // in use
+    std::size_t allocate() noexcept {
+        auto &start = hint();
+        for (std::size_t n = 0; n < s_num_words; n++) {
+            const auto i = (start + n) % s_num_words;
+            if (const auto slot = claim_in(i); slot < N) {
+                start = i;
+                return slot;
+            }
+        }
+        return N;
+    }
+
+    // Claims a specific slot, returning false if it is already in use
+    bool try_allocate(std::size_t slot) {
+        check_slot(slot, "try_allocate");
+        auto &word = m_data[underlying_index(slot)];
+        if constexpr (Concurrent) {
+            return (word.fetch_or(mask(slot), std::memory_order_acquire) &
+                    mask(slot)) == underlying_type_t{0};
+        } else {
+            const bool is_free = (word & mask(slot)) == underlying_type_t{0};
+            word |= mask(slot);
+            return is_free;
+        }
+    }
+
+    // Releases a slot. Throws std::invalid_argument if it is not in use.
+    void deallocate(std::size_t slot) {
+        check_slot(slot, "deallocate");
+        auto &word = m_data[underlying_index(slot)];
+        underlying_type_t previous;
+        if constexpr (Concurrent) {
+            previous = word.fetch_and(
+                static_cast<underlying_type_t>(~mask(slot)),
+                std::memory_order_release);
+        } else {
+            previous = word;
+            word &= static_cast<underlying_type_t>(~mask(slot));
+            // Keeps the slots in use packed towards the start
+            m_hint = std::min(m_hint, underlying_index(slot));
+        }
+        if ((previous & mask(slot)) == underlying_type_t{0}) {
+            throw std::invalid_argument(
+                "bitmap_allocator::deallocate: slot is not allocated");
+        }
+    }
+
+    bool is_allocated(std::size_t slot) const {
+        check_slot(slot, "is_allocated");
+        return (load(underlying_index(slot)) & mask(slot)) !=
+               underlying_type_t{0};
+    }
+
+    // The number of slots in use. With Concurrent this is only a snapshot.
+    std::size_t count() const noexcept {
+        std::size_t cnt{0};
+        for (std::size_t i = 0; i < s_num_words; i++) {
+            cnt += detail::popcount(load(i));
+        }
+        return cnt - detail::popcount(s_padding);
+    }
+
+    bool full() const noexcept { return count() == N; }
+
+    // The slots in use as a bitset, whatever the words of the allocator are
+    bitset<N> allocated() const noexcept {
+        bitset<N> bits;
+        for (std::size_t i = 0; i < s_num_words; i++) {
+            const std::size_t pos = i * s_num_underlying_bits;
+            bits.insert(pos, std::min(s_num_underlying_bits, N - pos),
+                        load(i));
+        }
+        return bits;
+    }
+};
+
+} // namespace nonstd
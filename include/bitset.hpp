@@ -1,6 +1,8 @@
 
 #pragma once
 
+#include "bitset_dispatch.hpp"
+
 #include <array>
 #include <cstddef>
 #include <cstdint>
@@ -8,10 +10,409 @@
 #include <iosfwd>
 #include <iterator>
 #include <stdexcept>
+#include <string>
 #include <type_traits>
 
+#if __cplusplus >= 202002L && __has_include(<span>)
+#include <span>
+#endif
+
 namespace nonstd {
 
+#if defined(__cpp_lib_span)
+template <class T> using byte_span = std::span<T>;
+#else
+// The part of std::span used by bitset::as_bytes and bitset::from_bytes,
+// for C++17. With C++20 this is std::span itself.
+template <class T> class byte_span {
+  public:
+    constexpr byte_span() noexcept = default;
+    constexpr byte_span(T *data, std::size_t size) noexcept
+        : m_data(data), m_size(size) {}
+
+    // From a contiguous container of T, e.g. std::vector or std::array
+    template <class Container,
+              std::enable_if_t<std::is_convertible_v<
+                                   decltype(std::declval<Container &>().data()),
+                                   T *>,
+                               int> = 0>
+    constexpr byte_span(Container &container) noexcept
+        : m_data(container.data()), m_size(container.size()) {}
+
+    constexpr T *data() const noexcept { return m_data; }
+    constexpr std::size_t size() const noexcept { return m_size; }
+    constexpr bool empty() const noexcept { return m_size == 0; }
+    constexpr T *begin() const noexcept { return m_data; }
+    constexpr T *end() const noexcept { return m_data + m_size; }
+    constexpr T &operator[](std::size_t i) const noexcept { return m_data[i]; }
+
+  private:
+    T *m_data{nullptr};
+    std::size_t m_size{0};
+};
+#endif
+
+namespace detail {
+
+constexpr bool is_constant_evaluated() noexcept {
+#if defined(__cpp_lib_is_constant_evaluated)
+    return std::is_constant_evaluated();
+#elif defined(__has_builtin)
+#if __has_builtin(__builtin_is_constant_evaluated)
+    return __builtin_is_constant_evaluated();
+#else
+    return true;
+#endif
+#else
+    return true; // no way to tell, so always take the constexpr-safe path
+#endif
+}
+
+template <typename T> constexpr std::size_t popcount(T value) noexcept {
+    static_assert(std::is_unsigned_v<T>);
+#if defined(__GNUC__)
+    if constexpr (sizeof(T) <= sizeof(unsigned int)) {
+        return __builtin_popcount(value);
+    } else if constexpr (sizeof(T) <= sizeof(unsigned long)) {
+        return __builtin_popcountl(value);
+    } else if constexpr (sizeof(T) <= sizeof(unsigned long long)) {
+        return __builtin_popcountll(value);
+    }
+#endif
+    if constexpr (sizeof(T) <= sizeof(std::uint64_t)) {
+        // SWAR popcount
+        std::uint64_t v = value;
+        v = v - ((v >> 1) & 0x5555555555555555ull);
+        v = (v & 0x3333333333333333ull) + ((v >> 2) & 0x3333333333333333ull);
+        v = (v + (v >> 4)) & 0x0f0f0f0f0f0f0f0full;
+        return static_cast<std::size_t>((v * 0x0101010101010101ull) >> 56);
+    } else {
+        std::size_t cnt{0};
+        for (; value != T{0}; value &= value - 1) {
+            ++cnt;
+        }
+        return cnt;
+    }
+}
+
+// Number of trailing zero bits, value must not be zero
+template <typename T> constexpr std::size_t countr_zero(T value) noexcept {
+    static_assert(std::is_unsigned_v<T>);
+#if defined(__GNUC__)
+    if constexpr (sizeof(T) <= sizeof(unsigned int)) {
+        return __builtin_ctz(value);
+    } else if constexpr (sizeof(T) <= sizeof(unsigned long)) {
+        return __builtin_ctzl(value);
+    } else if constexpr (sizeof(T) <= sizeof(unsigned long long)) {
+        return __builtin_ctzll(value);
+    }
+#endif
+    std::size_t cnt{0};
+    for (; (value & T{1}) == T{0}; value >>= 1) {
+        ++cnt;
+    }
+    return cnt;
+}
+
+// Number of leading zero bits, value must not be zero
+template <typename T> constexpr std::size_t countl_zero(T value) noexcept {
+    static_assert(std::is_unsigned_v<T>);
+#if defined(__GNUC__)
+    if constexpr (sizeof(T) <= sizeof(unsigned int)) {
+        return __builtin_clz(value) - 8 * (sizeof(unsigned int) - sizeof(T));
+    } else if constexpr (sizeof(T) <= sizeof(unsigned long)) {
+        return __builtin_clzl(value) - 8 * (sizeof(unsigned long) - sizeof(T));
+    } else if constexpr (sizeof(T) <= sizeof(unsigned long long)) {
+        return __builtin_clzll(value) -
+               8 * (sizeof(unsigned long long) - sizeof(T));
+    }
+#endif
+    std::size_t cnt{0};
+    constexpr T kTopBit = T{1} << (8 * sizeof(T) - 1);
+    for (; (value & kTopBit) == T{0}; value <<= 1) {
+        ++cnt;
+    }
+    return cnt;
+}
+
+// Index of the first set bit at or after pos, or num_words * bits-per-word
+// if there is none.
+template <typename T>
+constexpr std::size_t find_next_set(const T *data, std::size_t num_words,
+                                    std::size_t pos) noexcept {
+    constexpr std::size_t kBits = 8 * sizeof(T);
+    std::size_t i = pos / kBits;
+    if (i >= num_words) {
+        return num_words * kBits;
+    }
+    T word = data[i] & static_cast<T>(static_cast<T>(~T{0}) << (pos % kBits));
+    if (word == T{0} && simd::k_bytes_in_bit_order<T> &&
+        (num_words - i - 1) * sizeof(T) >= simd::k_min_bytes &&
+        !is_constant_evaluated()) {
+        const std::size_t offset = (i + 1) * sizeof(T);
+        return 8 * offset +
+               dispatch::find_first(
+                   reinterpret_cast<const unsigned char *>(data) + offset,
+                   num_words * sizeof(T) - offset);
+    }
+    while (word == T{0}) {
+        if (++i == num_words) {
+            return num_words * kBits;
+        }
+        word = data[i];
+    }
+    return i * kBits + countr_zero(word);
+}
+
+// Index of the last set bit before pos, or num_words * bits-per-word if
+// there is none.
+template <typename T>
+constexpr std::size_t find_prev_set(const T *data, std::size_t num_words,
+                                    std::size_t pos) noexcept {
+    constexpr std::size_t kBits = 8 * sizeof(T);
+    if (pos == 0 || num_words == 0) {
+        return num_words * kBits;
+    }
+    const std::size_t end = pos < num_words * kBits ? pos : num_words * kBits;
+    const std::size_t last = end - 1;
+    std::size_t i = last / kBits;
+    T word = data[i] & static_cast<T>(static_cast<T>(~T{0}) >>
+                                      (kBits - 1 - last % kBits));
+    while (word == T{0}) {
+        if (i == 0) {
+            return num_words * kBits;
+        }
+        word = data[--i];
+    }
+    return i * kBits + (kBits - 1 - countl_zero(word));
+}
+
+// Counts the set bits of num_words words. At runtime the words are counted as
+// a byte buffer, in 64-bit loads or wider, whatever their type.
+template <typename T>
+constexpr std::size_t count_words(const T *data,
+                                  std::size_t num_words) noexcept {
+    if (!is_constant_evaluated()) {
+        return dispatch::count(reinterpret_cast<const unsigned char *>(data),
+                               num_words * sizeof(T));
+    }
+    std::size_t cnt{0};
+    for (std::size_t i = 0; i < num_words; ++i) {
+        cnt += popcount(data[i]);
+    }
+    return cnt;
+}
+
+struct and_op {
+    template <typename T> static constexpr T apply(T lhs, T rhs) noexcept {
+        return static_cast<T>(lhs & rhs);
+    }
+    static void kernel(unsigned char *dst, const unsigned char *lhs,
+                       const unsigned char *rhs, std::size_t n) noexcept {
+        dispatch::bit_and(dst, lhs, rhs, n);
+    }
+    static std::size_t count(const unsigned char *lhs,
+                             const unsigned char *rhs, std::size_t n) noexcept {
+        return dispatch::count_and(lhs, rhs, n);
+    }
+    static bool any(const unsigned char *lhs, const unsigned char *rhs,
+                    std::size_t n) noexcept {
+        return dispatch::any_and(lhs, rhs, n);
+    }
+};
+
+struct or_op {
+    template <typename T> static constexpr T apply(T lhs, T rhs) noexcept {
+        return static_cast<T>(lhs | rhs);
+    }
+    static void kernel(unsigned char *dst, const unsigned char *lhs,
+                       const unsigned char *rhs, std::size_t n) noexcept {
+        dispatch::bit_or(dst, lhs, rhs, n);
+    }
+    static std::size_t count(const unsigned char *lhs,
+                             const unsigned char *rhs, std::size_t n) noexcept {
+        return dispatch::count_or(lhs, rhs, n);
+    }
+};
+
+struct xor_op {
+    template <typename T> static constexpr T apply(T lhs, T rhs) noexcept {
+        return static_cast<T>(lhs ^ rhs);
+    }
+    static void kernel(unsigned char *dst, const unsigned char *lhs,
+                       const unsigned char *rhs, std::size_t n) noexcept {
+        dispatch::bit_xor(dst, lhs, rhs, n);
+    }
+    static std::size_t count(const unsigned char *lhs,
+                             const unsigned char *rhs, std::size_t n) noexcept {
+        return dispatch::count_xor(lhs, rhs, n);
+    }
+};
+
+struct and_not_op {
+    template <typename T> static constexpr T apply(T lhs, T rhs) noexcept {
+        return static_cast<T>(lhs & ~rhs);
+    }
+    static std::size_t count(const unsigned char *lhs,
+                             const unsigned char *rhs, std::size_t n) noexcept {
+        return dispatch::count_and_not(lhs, rhs, n);
+    }
+    static bool any(const unsigned char *lhs, const unsigned char *rhs,
+                    std::size_t n) noexcept {
+        return dispatch::any_and_not(lhs, rhs, n);
+    }
+};
+
+// Counts the set bits of op(lhs[i], rhs[i]) over num_words words in one pass
+template <class Op, typename T>
+constexpr std::size_t count_words(const T *lhs, const T *rhs,
+                                  std::size_t num_words) noexcept {
+    if (!is_constant_evaluated()) {
+        return Op::count(reinterpret_cast<const unsigned char *>(lhs),
+                         reinterpret_cast<const unsigned char *>(rhs),
+                         num_words * sizeof(T));
+    }
+    std::size_t cnt{0};
+    for (std::size_t i = 0; i < num_words; ++i) {
+        cnt += popcount(Op::apply(lhs[i], rhs[i]));
+    }
+    return cnt;
+}
+
+// Whether op(lhs[i], rhs[i]) is non-zero for any of num_words words, stopping
+// at the first one that is
+template <class Op, typename T>
+constexpr bool any_words(const T *lhs, const T *rhs,
+                         std::size_t num_words) noexcept {
+    if (!is_constant_evaluated() &&
+        num_words * sizeof(T) >= simd::k_min_bytes) {
+        return Op::any(reinterpret_cast<const unsigned char *>(lhs),
+                       reinterpret_cast<const unsigned char *>(rhs),
+                       num_words * sizeof(T));
+    }
+    for (std::size_t i = 0; i < num_words; ++i) {
+        if (Op::apply(lhs[i], rhs[i]) != T{0}) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Multiplies two 64-bit values and folds the 128-bit product, the mixing
+// step of wyhash
+constexpr std::uint64_t hash_mix(std::uint64_t lhs,
+                                 std::uint64_t rhs) noexcept {
+#if defined(__SIZEOF_INT128__)
+    const unsigned __int128 product = static_cast<unsigned __int128>(lhs) * rhs;
+    return static_cast<std::uint64_t>(product) ^
+           static_cast<std::uint64_t>(product >> 64);
+#else
+    const std::uint64_t lhs_hi = lhs >> 32, lhs_lo = lhs & 0xffffffffull;
+    const std::uint64_t rhs_hi = rhs >> 32, rhs_lo = rhs & 0xffffffffull;
+    const std::uint64_t lo_lo = lhs_lo * rhs_lo;
+    const std::uint64_t hi_lo = lhs_hi * rhs_lo;
+    const std::uint64_t lo_hi = lhs_lo * rhs_hi;
+    const std::uint64_t cross =
+        (lo_lo >> 32) + (hi_lo & 0xffffffffull) + lo_hi;
+    const std::uint64_t hi = lhs_hi * rhs_hi + (hi_lo >> 32) + (cross >> 32);
+    return ((cross << 32) | (lo_lo & 0xffffffffull)) ^ hi;
+#endif
+}
+
+// Bits 64 * i and up of num_words words, zero past the end. At runtime on
+// little-endian hosts this is a single load whatever the type of the words.
+template <typename T>
+constexpr std::uint64_t hash_lane(const T *data, std::size_t num_words,
+                                  std::size_t i) noexcept {
+    static_assert(sizeof(T) <= sizeof(std::uint64_t));
+    constexpr std::size_t kWordsPerLane = sizeof(std::uint64_t) / sizeof(T);
+    const std::size_t first = i * kWordsPerLane;
+    const std::size_t count =
+        num_words - first < kWordsPerLane ? num_words - first : kWordsPerLane;
+    if (simd::k_little_endian && !is_constant_evaluated()) {
+        std::uint64_t lane{0};
+        if (count == kWordsPerLane) {
+            std::memcpy(&lane, data + first, sizeof lane);
+        } else {
+            std::memcpy(&lane, data + first, count * sizeof(T));
+        }
+        return lane;
+    }
+    std::uint64_t lane{0};
+    for (std::size_t j = 0; j < count; ++j) {
+        lane |= static_cast<std::uint64_t>(data[first + j])
+                << (8 * sizeof(T) * j);
+    }
+    return lane;
+}
+
+// Hashes num_bits bits held in num_words words, the bits above num_bits being
+// zero, 64 bits at a time in the manner of wyhash. The result depends only on
+// the bits, not on T or the host's byte order.
+template <typename T>
+constexpr std::size_t hash_words(const T *data, std::size_t num_words,
+                                 std::size_t num_bits) noexcept {
+    constexpr std::uint64_t kSecret[4] = {
+        0xa0761d6478bd642full, 0xe7037ed1a0b428dbull, 0x8ebc6af09c88c6e3ull,
+        0x589965cc75374cc3ull};
+    const std::size_t num_lanes = (num_bits + 63) / 64;
+    std::uint64_t seed = hash_mix(num_bits ^ kSecret[0], kSecret[1]);
+    std::size_t i{0};
+    if (num_lanes > 6) {
+        // Three independent chains so the multiplies overlap
+        std::uint64_t seed1 = seed;
+        std::uint64_t seed2 = seed;
+        for (; i + 6 <= num_lanes; i += 6) {
+            seed = hash_mix(hash_lane(data, num_words, i) ^ kSecret[1],
+                            hash_lane(data, num_words, i + 1) ^ seed);
+            seed1 = hash_mix(hash_lane(data, num_words, i + 2) ^ kSecret[2],
+                             hash_lane(data, num_words, i + 3) ^ seed1);
+            seed2 = hash_mix(hash_lane(data, num_words, i + 4) ^ kSecret[3],
+                             hash_lane(data, num_words, i + 5) ^ seed2);
+        }
+        seed ^= seed1 ^ seed2;
+    }
+    for (; i + 2 <= num_lanes; i += 2) {
+        seed = hash_mix(hash_lane(data, num_words, i) ^ kSecret[1],
+                        hash_lane(data, num_words, i + 1) ^ seed);
+    }
+    if (i < num_lanes) {
+        seed = hash_mix(hash_lane(data, num_words, i) ^ kSecret[1],
+                        kSecret[2] ^ seed);
+    }
+    return static_cast<std::size_t>(
+        hash_mix(seed ^ kSecret[3], num_bits ^ kSecret[1]));
+}
+
+// Whether T is one of the expression templates of Bitset
+template <class T, class Bitset, class = void>
+struct is_expr_of : std::false_type {};
+
+template <class T, class Bitset>
+struct is_expr_of<T, Bitset, std::void_t<typename T::result_type>>
+    : std::is_same<typename T::result_type, Bitset> {};
+
+struct bitset_access;
+
+// Reads the get area of a stream buffer without copying it. The members are
+// protected, but a pointer to them can be formed through a derived class.
+template <class CharT, class Traits>
+struct streambuf_access : std::basic_streambuf<CharT, Traits> {
+    using base = std::basic_streambuf<CharT, Traits>;
+
+    static const CharT *next(base &buf) {
+        return (buf.*&streambuf_access::gptr)();
+    }
+
+    static const CharT *end(base &buf) {
+        return (buf.*&streambuf_access::egptr)();
+    }
+
+    static void bump(base &buf, int n) { (buf.*&streambuf_access::gbump)(n); }
+};
+
+} // namespace detail
+
 template <std::size_t N, typename Underlying = std::uint8_t> class bitset {
     static_assert(std::is_unsigned_v<Underlying>,
                   "bitset requires an unsigned underlying type");
@@ -32,13 +433,325 @@ template <std::size_t N, typename Underlying = std::uint8_t> class bitset {
     static constexpr underlying_type_t s_last_word_mask =
         (N % s_num_underlying_bits == 0)
             ? ~underlying_type_t{0}
-            : ~underlying_type_t{0} >>
+            : underlying_type_t(~underlying_type_t{0}) >>
                   (s_num_underlying_bits - (N % s_num_underlying_bits));
 
     static constexpr underlying_type_t mask(std::size_t pos) noexcept {
         return underlying_type_t{1} << (pos % s_num_underlying_bits);
     }
 
+    // Whether to hand bulk operations to the SIMD kernels, see
+    // bitset_dispatch.hpp. Small bitsets and constant evaluation use the
+    // plain word loops.
+    static constexpr bool use_simd() noexcept {
+        return sizeof(m_data) >= detail::simd::k_min_bytes &&
+               !detail::is_constant_evaluated();
+    }
+
+    static constexpr bool s_bytes_in_bit_order =
+        detail::simd::k_bytes_in_bit_order<underlying_type_t>;
+
+    // Several words that fit in one 64-bit lane are shifted as one integer.
+    // Larger bitsets are shifted by the kernels, a memmove of whole bytes
+    // plus a funnel shift of 64-bit lanes, whatever the underlying type.
+    static constexpr bool use_lane_shift() noexcept {
+        return s_num_words > 1 &&
+               s_num_words * sizeof(underlying_type_t) <=
+                   sizeof(std::uint64_t) &&
+               detail::simd::k_little_endian &&
+               !detail::is_constant_evaluated();
+    }
+
+    // Only called if use_lane_shift(), but instantiated for every size
+    static constexpr std::size_t s_lane_bytes =
+        sizeof(m_data) < sizeof(std::uint64_t) ? sizeof(m_data)
+                                               : sizeof(std::uint64_t);
+
+    std::uint64_t load_lane(std::size_t byte = 0) const noexcept {
+        std::uint64_t lane{0};
+        std::memcpy(&lane, bytes() + byte, s_lane_bytes);
+        return lane;
+    }
+
+    void store_lane(std::uint64_t lane, std::size_t byte = 0) noexcept {
+        std::memcpy(bytes() + byte, &lane, s_lane_bytes);
+    }
+
+    unsigned char *bytes() noexcept {
+        return reinterpret_cast<unsigned char *>(m_data.data());
+    }
+
+    const unsigned char *bytes() const noexcept {
+        return reinterpret_cast<const unsigned char *>(m_data.data());
+    }
+
+    // Whether strings of CharT can be converted by the format_bits and
+    // parse_bits kernels, which compare single bytes and expect the words in
+    // little-endian order
+    template <class CharT, class Traits>
+    static constexpr bool s_text_kernels_v =
+        sizeof(CharT) == 1 &&
+        std::is_same_v<Traits, std::char_traits<CharT>> &&
+        detail::simd::k_little_endian;
+
+    template <class CharT>
+    [[noreturn]] static void throw_unexpected_character(CharT c, CharT zero,
+                                                        CharT one) {
+        throw std::invalid_argument(std::string("Unexpected character ") + c +
+                                    " is neither zero (" + zero +
+                                    ") or one (" + one + ")");
+    }
+
+    // Sets the bits from the len characters at first, the last one being bit
+    // 0, if the kernels can; the bits must all be zero. Returns false to
+    // leave the conversion to the caller, e.g. for strings longer than N
+    // which the caller reports as out of range.
+    template <class CharT, class Traits>
+    constexpr bool parse_with_kernel(const CharT *first, std::size_t len,
+                                     CharT zero, CharT one) {
+        if constexpr (s_text_kernels_v<CharT, Traits>) {
+            if (len <= N && !detail::is_constant_evaluated()) {
+                const auto invalid = detail::dispatch::parse_bits(
+                    bytes(), reinterpret_cast<const unsigned char *>(first),
+                    len, static_cast<unsigned char>(zero),
+                    static_cast<unsigned char>(one));
+                if (invalid != len) {
+                    throw_unexpected_character(first[invalid], zero, one);
+                }
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static constexpr std::size_t found_or_size(std::size_t pos) noexcept {
+        return pos < N ? pos : N;
+    }
+
+    // The words holding the bits [pos, pos + len), len > 0, and the masks of
+    // those bits in the first and last word. If first == last, only
+    // head & tail is in the range.
+    struct word_range {
+        std::size_t first;
+        std::size_t last;
+        underlying_type_t head;
+        underlying_type_t tail;
+    };
+
+    static constexpr word_range range_words(std::size_t pos,
+                                            std::size_t len) noexcept {
+        constexpr underlying_type_t ones = ~underlying_type_t{0};
+        const std::size_t end = pos + len - 1;
+        return {underlying_index(pos), underlying_index(end),
+                static_cast<underlying_type_t>(
+                    ones << (pos % s_num_underlying_bits)),
+                static_cast<underlying_type_t>(
+                    ones >> (s_num_underlying_bits - 1 -
+                             end % s_num_underlying_bits))};
+    }
+
+    [[noreturn]] static void throw_range_error(const char *what) {
+        throw std::out_of_range(std::string("bitset::") + what +
+                                ": range out of range");
+    }
+
+    // The throw is out of line and noreturn, so that the optimizer drops the
+    // word accesses of an out-of-range call instead of warning about them
+    static constexpr void check_range(std::size_t pos, std::size_t len,
+                                      const char *what) {
+        if (pos > N || len > N - pos) {
+            throw_range_error(what);
+        }
+    }
+
+    static constexpr std::uint64_t low_bits(std::size_t len) noexcept {
+        return len >= 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << len) - 1;
+    }
+
+    // The byte of the 64-bit lane that extract and insert load for a field
+    // at pos: the byte of pos, or the last whole lane near the end, which
+    // then holds the entire field
+    static constexpr std::size_t field_lane_byte(std::size_t pos) noexcept {
+        if constexpr (sizeof(m_data) <= sizeof(std::uint64_t)) {
+            return 0;
+        } else {
+            const std::size_t last = sizeof(m_data) - sizeof(std::uint64_t);
+            return pos / 8 < last ? pos / 8 : last;
+        }
+    }
+
+    static constexpr void check_field(std::size_t len, std::size_t max_len,
+                                      const char *what) {
+        if (len > max_len) {
+            throw std::invalid_argument(std::string("bitset::") + what +
+                                        ": len exceeds the bits of the field");
+        }
+    }
+
+    // Sets the len bits at pos, which must be in range, to value
+    constexpr void assign_bits(std::size_t pos, std::size_t len,
+                               bool value) noexcept {
+        if (len == 0) {
+            return;
+        }
+        const auto r = range_words(pos, len);
+        const auto apply = [this, value](std::size_t i, underlying_type_t m) {
+            if (value) {
+                m_data[i] |= m;
+            } else {
+                m_data[i] &= static_cast<underlying_type_t>(~m);
+            }
+        };
+        // The multi-word path is discarded for a single word, which keeps
+        // GCC from warning about the inner words it cannot prove unused
+        if constexpr (s_num_words > 1) {
+            if (r.first != r.last) {
+                apply(r.first, r.head);
+                const underlying_type_t fill =
+                    value ? ~underlying_type_t{0} : 0;
+                for (std::size_t i = r.first + 1; i < r.last; i++) {
+                    m_data[i] = fill;
+                }
+                apply(r.last, r.tail);
+                return;
+            }
+        }
+        apply(r.first, r.head & r.tail);
+    }
+
+    // The len <= 64 bits at pos, which must be in range. At runtime, with
+    // the bytes in bit order, a 64-bit load and the byte after it hold them
+    // all; otherwise they are gathered word by word.
+    constexpr std::uint64_t extract_bits(std::size_t pos,
+                                         std::size_t len) const noexcept {
+        if (len == 0) {
+            return 0;
+        }
+        if (s_bytes_in_bit_order && !detail::is_constant_evaluated()) {
+            const std::size_t byte = field_lane_byte(pos);
+            const std::size_t shift = pos - 8 * byte;
+            std::uint64_t value = load_lane(byte) >> shift;
+            // A bitset of at most one lane never has a byte after it
+            if constexpr (sizeof(m_data) > sizeof(std::uint64_t)) {
+                if (shift + len > 64) {
+                    value |= std::uint64_t{bytes()[byte + 8]}
+                             << (64 - shift);
+                }
+            }
+            return value & low_bits(len);
+        }
+        std::uint64_t value{0};
+        for (std::size_t done = 0; done < len;) {
+            const std::size_t offset = (pos + done) % s_num_underlying_bits;
+            value |= static_cast<std::uint64_t>(
+                         m_data[underlying_index(pos + done)] >> offset)
+                     << done;
+            done += s_num_underlying_bits - offset;
+        }
+        return value & low_bits(len);
+    }
+
+    // Replaces the len <= 64 bits at pos, which must be in range, by the low
+    // len bits of value
+    constexpr void insert_bits(std::size_t pos, std::size_t len,
+                               std::uint64_t value) noexcept {
+        if (len == 0) {
+            return;
+        }
+        const std::uint64_t field = low_bits(len);
+        value &= field;
+        if (s_bytes_in_bit_order && !detail::is_constant_evaluated()) {
+            const std::size_t byte = field_lane_byte(pos);
+            const std::size_t shift = pos - 8 * byte;
+            const std::uint64_t lane = load_lane(byte);
+            store_lane((lane & ~(field << shift)) | value << shift, byte);
+            if constexpr (sizeof(m_data) > sizeof(std::uint64_t)) {
+                if (shift + len > 64) {
+                    unsigned char &next = bytes()[byte + 8];
+                    next = static_cast<unsigned char>(
+                        (next & ~(field >> (64 - shift))) |
+                        value >> (64 - shift));
+                }
+            }
+            return;
+        }
+        for (std::size_t done = 0; done < len;) {
+            const std::size_t offset = (pos + done) % s_num_underlying_bits;
+            const std::size_t n = s_num_underlying_bits - offset < len - done
+                                      ? s_num_underlying_bits - offset
+                                      : len - done;
+            const auto m =
+                static_cast<underlying_type_t>(low_bits(n) << offset);
+            auto &word = m_data[underlying_index(pos + done)];
+            word = static_cast<underlying_type_t>(
+                (word & ~m) | ((value >> done) << offset & m));
+            done += n;
+        }
+    }
+
+    // The whole words strictly between the first and last word of a range
+    // are filled, inverted or scanned by the kernels when there are enough
+    // of them
+    static constexpr bool use_simd_range(std::size_t num_words) noexcept {
+        return num_words * sizeof(underlying_type_t) >=
+                   detail::simd::k_min_bytes &&
+               !detail::is_constant_evaluated();
+    }
+
+    template <class T>
+    static constexpr bool is_expr_v = detail::is_expr_of<T, bitset>::value;
+
+    template <class T>
+    static constexpr bool is_operand_v =
+        std::is_same_v<T, bitset> || is_expr_v<T>;
+
+    // Operand types for which &, | and ^ build a nested expression
+    template <class Lhs, class Rhs>
+    static constexpr bool is_expr_pair_v = is_operand_v<Lhs> &&
+                                           is_operand_v<Rhs> &&
+                                           (is_expr_v<Lhs> || is_expr_v<Rhs>);
+
+    // Expressions hold bitsets by reference and sub-expressions by value
+    template <class T>
+    using operand_t =
+        std::conditional_t<std::is_same_v<T, bitset>, const bitset &, T>;
+
+    template <class Op>
+    constexpr std::size_t count_words_with(const bitset &other) const noexcept {
+        return detail::count_words<Op>(m_data.data(), other.m_data.data(),
+                                       s_num_words);
+    }
+
+    static constexpr underlying_type_t word_of(const bitset &bits,
+                                               std::size_t i) noexcept {
+        return bits.m_data[i];
+    }
+
+    template <class E>
+    static constexpr underlying_type_t word_of(const E &e,
+                                               std::size_t i) noexcept {
+        return e.word(i);
+    }
+
+    // Clears the bits above N, which the words of an expression may have set
+    static constexpr underlying_type_t masked(underlying_type_t word,
+                                              std::size_t i) noexcept {
+        return i == s_num_words - 1
+                   ? static_cast<underlying_type_t>(word & s_last_word_mask)
+                   : word;
+    }
+
+    template <class Lhs, class Rhs>
+    static constexpr bool words_equal(const Lhs &lhs,
+                                      const Rhs &rhs) noexcept {
+        for (std::size_t i = 0; i < s_num_words; i++) {
+            if (masked(word_of(lhs, i), i) != masked(word_of(rhs, i), i)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
   public:
     constexpr bitset() noexcept = default;
 
@@ -66,10 +779,14 @@ template <std::size_t N, typename Underlying = std::uint8_t> class bitset {
         if (pos > str.size()) {
             throw std::out_of_range("pos > str.size()");
         }
+        const auto len = n < str.size() - pos ? n : str.size() - pos;
+        if (parse_with_kernel<CharT, Traits>(str.data() + pos, len, zero,
+                                             one)) {
+            return;
+        }
 
-        auto i = 0;
-        auto reverse_start = std::reverse_iterator(
-            n == str.npos ? str.end() : str.begin() + pos + n);
+        std::size_t i = 0;
+        auto reverse_start = std::reverse_iterator(str.begin() + pos + len);
         auto reverse_end = std::reverse_iterator(str.begin() + pos);
         auto iter = reverse_start;
         while (iter != reverse_end) {
@@ -78,9 +795,7 @@ template <std::size_t N, typename Underlying = std::uint8_t> class bitset {
             } else if (Traits::eq(*iter, one)) {
                 set(i, 1);
             } else {
-                throw std::invalid_argument(
-                    std::string("Unexpected character ") + *iter +
-                    " is neither zero (" + zero + ") or one (" + one + ")");
+                throw_unexpected_character(*iter, zero, one);
             }
             ++i;
             ++iter;
@@ -96,6 +811,11 @@ template <std::size_t N, typename Underlying = std::uint8_t> class bitset {
             n = len;
         }
 
+        if (parse_with_kernel<CharT, std::char_traits<CharT>>(end - n, n, zero,
+                                                              one)) {
+            return;
+        }
+
         auto iter = std::reverse_iterator(end);
         auto reverse_end = std::reverse_iterator(end - n);
 
@@ -104,9 +824,7 @@ template <std::size_t N, typename Underlying = std::uint8_t> class bitset {
             if (*iter == one) {
                 set(i, 1);
             } else if (*iter != zero) {
-                throw std::invalid_argument(
-                    std::string("Unexpected character ") + *iter +
-                    " is neither zero (" + zero + ") or one (" + one + ")");
+                throw_unexpected_character(*iter, zero, one);
             }
             ++i;
             ++iter;
@@ -155,6 +873,323 @@ template <std::size_t N, typename Underlying = std::uint8_t> class bitset {
         std::size_t m_pos;
     };
 
+    // Forward iterator over the positions of the set bits, in increasing
+    // order. Dereferencing yields the position by value.
+    class set_bit_iterator {
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = std::size_t;
+
+        constexpr set_bit_iterator() noexcept = default;
+
+        constexpr reference operator*() const noexcept {
+            return m_index * s_num_underlying_bits +
+                   detail::countr_zero(m_word);
+        }
+
+        constexpr set_bit_iterator &operator++() noexcept {
+            m_word = static_cast<underlying_type_t>(m_word & (m_word - 1));
+            skip_zero_words();
+            return *this;
+        }
+
+        constexpr set_bit_iterator operator++(int) noexcept {
+            set_bit_iterator copy(*this);
+            ++*this;
+            return copy;
+        }
+
+        friend constexpr bool operator==(const set_bit_iterator &lhs,
+                                         const set_bit_iterator &rhs) noexcept {
+            return lhs.m_index == rhs.m_index && lhs.m_word == rhs.m_word;
+        }
+
+        friend constexpr bool operator!=(const set_bit_iterator &lhs,
+                                         const set_bit_iterator &rhs) noexcept {
+            return !(lhs == rhs);
+        }
+
+      private:
+        friend bitset;
+        constexpr set_bit_iterator(const bitset &parent,
+                                   std::size_t index) noexcept
+            : m_data(parent.m_data.data()), m_index(index),
+              m_word(index < s_num_words ? m_data[index]
+                                         : underlying_type_t{0}) {
+            skip_zero_words();
+        }
+
+        constexpr void skip_zero_words() noexcept {
+            while (m_word == underlying_type_t{0} && m_index < s_num_words) {
+                if (++m_index < s_num_words) {
+                    m_word = m_data[m_index];
+                }
+            }
+        }
+
+        const underlying_type_t *m_data{nullptr};
+        std::size_t m_index{s_num_words};
+        underlying_type_t m_word{0};
+    };
+
+    class set_bit_range {
+      public:
+        using iterator = set_bit_iterator;
+        using const_iterator = set_bit_iterator;
+
+        constexpr iterator begin() const noexcept {
+            return set_bit_iterator(m_parent, 0);
+        }
+        constexpr iterator end() const noexcept {
+            return set_bit_iterator(m_parent, s_num_words);
+        }
+
+      private:
+        friend bitset;
+        constexpr explicit set_bit_range(const bitset &parent) noexcept
+            : m_parent(parent) {}
+
+        const bitset &m_parent;
+    };
+
+    constexpr set_bit_range set_bits() const noexcept {
+        return set_bit_range(*this);
+    }
+
+    // Expression templates. &, |, ^ and ~ build expression objects rather than
+    // bitsets. An expression is evaluated in a single word-by-word pass when it
+    // is assigned to or converted into a bitset, and count(), any(), none(),
+    // all() and == reduce it without writing out any intermediate bitset.
+    // The other const members of bitset, such as test(), to_string() and the
+    // shifts, act on the evaluated result. Bitset operands are held by
+    // reference, so an expression must not outlive them; use eval(), or a
+    // bitset rather than auto, to keep or modify the result.
+    template <class Operand> class not_expr;
+
+    template <class Derived> class expr {
+      public:
+        using result_type = bitset;
+
+        constexpr std::size_t size() const noexcept { return N; }
+
+        constexpr bool operator[](std::size_t i) const noexcept {
+            return (self().word(underlying_index(i)) & mask(i)) !=
+                   underlying_type_t{0};
+        }
+
+        constexpr std::size_t count() const noexcept {
+            std::size_t cnt{0};
+            if (!detail::is_constant_evaluated()) {
+                // Evaluated a block at a time for the bulk popcount kernel
+                constexpr std::size_t max_block_words =
+                    detail::dispatch::k_min_bytes / sizeof(underlying_type_t);
+                constexpr std::size_t block_words =
+                    s_num_words < max_block_words ? s_num_words
+                                                  : max_block_words;
+                std::array<underlying_type_t, block_words> block{};
+                for (std::size_t i = 0; i < s_num_words; i += block_words) {
+                    const std::size_t n = s_num_words - i < block_words
+                                              ? s_num_words - i
+                                              : block_words;
+                    for (std::size_t j = 0; j < n; j++) {
+                        block[j] = masked(self().word(i + j), i + j);
+                    }
+                    cnt += detail::dispatch::count(
+                        reinterpret_cast<const unsigned char *>(block.data()),
+                        n * sizeof(underlying_type_t));
+                }
+                return cnt;
+            }
+            for (std::size_t i = 0; i < s_num_words - 1; i++) {
+                cnt += detail::popcount(self().word(i));
+            }
+            return cnt + detail::popcount(masked(self().word(s_num_words - 1),
+                                                 s_num_words - 1));
+        }
+
+        constexpr bool any() const noexcept {
+            for (std::size_t i = 0; i < s_num_words; i++) {
+                if (masked(self().word(i), i) != underlying_type_t{0}) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        constexpr bool none() const noexcept { return !self().any(); }
+
+        constexpr bool all() const noexcept {
+            constexpr underlying_type_t ones = ~underlying_type_t{0};
+            for (std::size_t i = 0; i < s_num_words - 1; i++) {
+                if (self().word(i) != ones) {
+                    return false;
+                }
+            }
+            return masked(self().word(s_num_words - 1), s_num_words - 1) ==
+                   s_last_word_mask;
+        }
+
+        constexpr bitset eval() const noexcept { return bitset(*this); }
+
+        // The rest of the const interface of bitset, on the evaluated result
+        bool test(std::size_t pos) const { return eval().test(pos); }
+
+        template <class CharT = char, class Traits = std::char_traits<CharT>,
+                  class Allocator = std::allocator<CharT>>
+        std::basic_string<CharT, Traits, Allocator>
+        to_string(CharT zero = CharT('0'), CharT one = CharT('1')) const {
+            return eval().template to_string<CharT, Traits, Allocator>(zero,
+                                                                       one);
+        }
+
+        constexpr unsigned long to_ulong() const { return eval().to_ulong(); }
+
+        constexpr unsigned long long to_ullong() const {
+            return eval().to_ullong();
+        }
+
+        constexpr bitset operator<<(std::size_t shift) const noexcept {
+            return eval() << shift;
+        }
+
+        constexpr bitset operator>>(std::size_t shift) const noexcept {
+            return eval() >> shift;
+        }
+
+        constexpr not_expr<Derived> operator~() const noexcept {
+            return not_expr<Derived>(self());
+        }
+
+        friend constexpr bool operator==(const expr &lhs,
+                                         const bitset &rhs) noexcept {
+            return lhs.equals(rhs);
+        }
+
+        friend constexpr bool operator==(const bitset &lhs,
+                                         const expr &rhs) noexcept {
+            return rhs.equals(lhs);
+        }
+
+        friend constexpr bool operator!=(const expr &lhs,
+                                         const bitset &rhs) noexcept {
+            return !lhs.equals(rhs);
+        }
+
+        friend constexpr bool operator!=(const bitset &lhs,
+                                         const expr &rhs) noexcept {
+            return !rhs.equals(lhs);
+        }
+
+      private:
+        constexpr bool equals(const bitset &other) const noexcept {
+            return words_equal(self(), other);
+        }
+
+        constexpr const Derived &self() const noexcept {
+            return static_cast<const Derived &>(*this);
+        }
+    };
+
+    template <class Op, class Lhs, class Rhs>
+    class binary_expr : public expr<binary_expr<Op, Lhs, Rhs>> {
+      public:
+        constexpr binary_expr(const Lhs &lhs, const Rhs &rhs) noexcept
+            : m_lhs(lhs), m_rhs(rhs) {}
+
+        constexpr underlying_type_t word(std::size_t i) const noexcept {
+            return Op::apply(word_of(m_lhs, i), word_of(m_rhs, i));
+        }
+
+        // An operation on two bitsets is reduced by the fused kernels
+        constexpr std::size_t count() const noexcept {
+            if constexpr (s_on_bitsets) {
+                return m_lhs.template count_words_with<Op>(m_rhs);
+            } else {
+                return expr<binary_expr>::count();
+            }
+        }
+
+        constexpr bool any() const noexcept {
+            if constexpr (s_on_bitsets && std::is_same_v<Op, detail::and_op>) {
+                return m_lhs.intersects(m_rhs);
+            } else {
+                return expr<binary_expr>::any();
+            }
+        }
+
+      private:
+        friend bitset;
+        static constexpr bool s_on_bitsets =
+            std::is_same_v<Lhs, bitset> && std::is_same_v<Rhs, bitset>;
+
+        operand_t<Lhs> m_lhs;
+        operand_t<Rhs> m_rhs;
+    };
+
+    template <class Operand> class not_expr : public expr<not_expr<Operand>> {
+      public:
+        constexpr explicit not_expr(const Operand &operand) noexcept
+            : m_operand(operand) {}
+
+        constexpr underlying_type_t word(std::size_t i) const noexcept {
+            return static_cast<underlying_type_t>(~word_of(m_operand, i));
+        }
+
+      private:
+        friend bitset;
+        operand_t<Operand> m_operand;
+    };
+
+  private:
+    // Evaluating an expression is alias-safe: word i of the result only
+    // depends on word i of the operands
+    template <class E> constexpr void assign_words(const E &e) noexcept {
+        for (std::size_t i = 0; i < s_num_words; i++) {
+            m_data[i] = e.word(i);
+        }
+        m_data[s_num_words - 1] &= s_last_word_mask;
+    }
+
+    template <class E> constexpr void assign(const E &e) noexcept {
+        assign_words(e);
+    }
+
+    // A single operation on two bitsets is handed to the bulk kernels
+    template <class Op>
+    constexpr void assign(const binary_expr<Op, bitset, bitset> &e) noexcept {
+        if (use_simd()) {
+            Op::kernel(bytes(), e.m_lhs.bytes(), e.m_rhs.bytes(),
+                       sizeof m_data);
+            return;
+        }
+        assign_words(e);
+    }
+
+    constexpr void assign(const not_expr<bitset> &e) noexcept {
+        if (use_simd()) {
+            detail::dispatch::invert(bytes(), e.m_operand.bytes(),
+                                     sizeof m_data);
+            m_data[s_num_words - 1] &= s_last_word_mask;
+            return;
+        }
+        assign_words(e);
+    }
+
+  public:
+    template <class Derived>
+    constexpr bitset(const expr<Derived> &e) noexcept {
+        assign(static_cast<const Derived &>(e));
+    }
+
+    template <class Derived>
+    constexpr bitset &operator=(const expr<Derived> &e) noexcept {
+        assign(static_cast<const Derived &>(e));
+        return *this;
+    }
+
     constexpr bool operator[](std::size_t i) const {
         return (m_data[underlying_index(i)] & mask(i)) != underlying_type_t(0);
     }
@@ -213,17 +1248,78 @@ template <std::size_t N, typename Underlying = std::uint8_t> class bitset {
     }
 
     constexpr std::size_t count() const noexcept {
-        std::size_t cnt{0};
-        for (std::size_t i = 0; i < size(); ++i) {
-            if (this->operator[](i))
-                ++cnt;
+        return detail::count_words(m_data.data(), s_num_words);
+    }
+
+    // Single-pass reductions over two bitsets, without the intermediate bitset
+    // of e.g. (*this & other).count()
+    constexpr std::size_t
+    intersection_count(const bitset &other) const noexcept {
+        return count_words_with<detail::and_op>(other);
+    }
+
+    constexpr std::size_t union_count(const bitset &other) const noexcept {
+        return count_words_with<detail::or_op>(other);
+    }
+
+    // The number of bits set in *this but not in other
+    constexpr std::size_t difference_count(const bitset &other) const noexcept {
+        return count_words_with<detail::and_not_op>(other);
+    }
+
+    constexpr std::size_t hamming_distance(const bitset &other) const noexcept {
+        return count_words_with<detail::xor_op>(other);
+    }
+
+    constexpr bool intersects(const bitset &other) const noexcept {
+        return detail::any_words<detail::and_op>(m_data.data(),
+                                                 other.m_data.data(),
+                                                 s_num_words);
+    }
+
+    constexpr bool is_disjoint(const bitset &other) const noexcept {
+        return !intersects(other);
+    }
+
+    // Whether every bit set in *this is also set in other
+    constexpr bool is_subset_of(const bitset &other) const noexcept {
+        return !detail::any_words<detail::and_not_op>(
+            m_data.data(), other.m_data.data(), s_num_words);
+    }
+
+    // The find functions return size() if no matching bit is found
+    constexpr std::size_t find_first() const noexcept {
+        return found_or_size(
+            detail::find_next_set(m_data.data(), s_num_words, 0));
+    }
+
+    constexpr std::size_t find_next(std::size_t pos) const noexcept {
+        if (pos >= N) {
+            return N;
         }
-        return cnt;
+        return found_or_size(
+            detail::find_next_set(m_data.data(), s_num_words, pos + 1));
+    }
+
+    constexpr std::size_t find_last() const noexcept {
+        return found_or_size(
+            detail::find_prev_set(m_data.data(), s_num_words, N));
+    }
+
+    constexpr std::size_t find_prev(std::size_t pos) const noexcept {
+        return found_or_size(
+            detail::find_prev_set(m_data.data(), s_num_words, pos));
     }
 
     constexpr std::size_t size() const noexcept { return N; }
 
     constexpr bool all() const noexcept {
+        if (use_simd()) {
+            constexpr auto kLeadingBytes =
+                (s_num_words - 1) * sizeof(underlying_type_t);
+            return detail::dispatch::all_ones(bytes(), kLeadingBytes) &&
+                   m_data[s_num_words - 1] == s_last_word_mask;
+        }
         constexpr underlying_type_t ones = ~underlying_type_t{0};
         for (auto i = 0; i < s_num_words - 1; ++i) {
             if (m_data[i] != ones) {
@@ -234,6 +1330,9 @@ template <std::size_t N, typename Underlying = std::uint8_t> class bitset {
     }
 
     constexpr bool any() const noexcept {
+        if (use_simd()) {
+            return detail::dispatch::any(bytes(), sizeof m_data);
+        }
         for (auto i = 0; i < s_num_words - 1; ++i) {
             if (m_data[i] != underlying_type_t{0}) {
                 return true;
@@ -243,6 +1342,9 @@ template <std::size_t N, typename Underlying = std::uint8_t> class bitset {
     }
 
     constexpr bool none() const noexcept {
+        if (use_simd()) {
+            return !detail::dispatch::any(bytes(), sizeof m_data);
+        }
         for (auto i = 0; i < s_num_words; ++i) {
             if (m_data[i] != 0) {
                 return false;
@@ -260,7 +1362,176 @@ template <std::size_t N, typename Underlying = std::uint8_t> class bitset {
 
     constexpr bitset &reset(std::size_t pos) { return set(pos, false); }
 
+    // Operations on the len bits starting at pos, which throw
+    // std::out_of_range if pos + len > size(). The words at either end are
+    // masked and the whole words in between filled or scanned, so they take
+    // O(len / word size) steps rather than one per bit.
+    constexpr bitset &set(std::size_t pos, std::size_t len, bool value) {
+        check_range(pos, len, "set");
+        assign_bits(pos, len, value);
+        return *this;
+    }
+
+    constexpr bitset &reset(std::size_t pos, std::size_t len) {
+        check_range(pos, len, "reset");
+        assign_bits(pos, len, false);
+        return *this;
+    }
+
+    constexpr bitset &flip(std::size_t pos, std::size_t len) {
+        check_range(pos, len, "flip");
+        if (len == 0) {
+            return *this;
+        }
+        const auto r = range_words(pos, len);
+        if constexpr (s_num_words > 1) {
+            if (r.first != r.last) {
+                m_data[r.first] ^= r.head;
+                const std::size_t num_inner = r.last - r.first - 1;
+                if (use_simd_range(num_inner)) {
+                    auto *inner =
+                        bytes() + (r.first + 1) * sizeof(underlying_type_t);
+                    detail::dispatch::invert(
+                        inner, inner, num_inner * sizeof(underlying_type_t));
+                } else {
+                    for (std::size_t i = r.first + 1; i < r.last; i++) {
+                        m_data[i] = ~m_data[i];
+                    }
+                }
+                m_data[r.last] ^= r.tail;
+                return *this;
+            }
+        }
+        m_data[r.first] ^= r.head & r.tail;
+        return *this;
+    }
+
+    // Whether every bit in the range is set; true for an empty range
+    constexpr bool all_in(std::size_t pos, std::size_t len) const {
+        check_range(pos, len, "all_in");
+        if (len == 0) {
+            return true;
+        }
+        const auto r = range_words(pos, len);
+        if (r.first == r.last) {
+            const underlying_type_t m = r.head & r.tail;
+            return (m_data[r.first] & m) == m;
+        }
+        if ((m_data[r.first] & r.head) != r.head ||
+            (m_data[r.last] & r.tail) != r.tail) {
+            return false;
+        }
+        const std::size_t num_inner = r.last - r.first - 1;
+        if (use_simd_range(num_inner)) {
+            return detail::dispatch::all_ones(
+                bytes() + (r.first + 1) * sizeof(underlying_type_t),
+                num_inner * sizeof(underlying_type_t));
+        }
+        for (std::size_t i = r.first + 1; i < r.last; i++) {
+            if (m_data[i] != underlying_type_t(~underlying_type_t{0})) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Whether any bit in the range is set; false for an empty range
+    constexpr bool any_in(std::size_t pos, std::size_t len) const {
+        check_range(pos, len, "any_in");
+        if (len == 0) {
+            return false;
+        }
+        const auto r = range_words(pos, len);
+        if (r.first == r.last) {
+            return (m_data[r.first] & r.head & r.tail) != 0;
+        }
+        if ((m_data[r.first] & r.head) != 0 ||
+            (m_data[r.last] & r.tail) != 0) {
+            return true;
+        }
+        const std::size_t num_inner = r.last - r.first - 1;
+        if (use_simd_range(num_inner)) {
+            return detail::dispatch::any(
+                bytes() + (r.first + 1) * sizeof(underlying_type_t),
+                num_inner * sizeof(underlying_type_t));
+        }
+        for (std::size_t i = r.first + 1; i < r.last; i++) {
+            if (m_data[i] != underlying_type_t{0}) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // The number of bits set in the range
+    constexpr std::size_t count(std::size_t pos, std::size_t len) const {
+        check_range(pos, len, "count");
+        if (len == 0) {
+            return 0;
+        }
+        const auto r = range_words(pos, len);
+        if (r.first == r.last) {
+            return detail::popcount(
+                static_cast<underlying_type_t>(m_data[r.first] & r.head &
+                                               r.tail));
+        }
+        return detail::popcount(
+                   static_cast<underlying_type_t>(m_data[r.first] & r.head)) +
+               detail::count_words(m_data.data() + r.first + 1,
+                                   r.last - r.first - 1) +
+               detail::popcount(
+                   static_cast<underlying_type_t>(m_data[r.last] & r.tail));
+    }
+
+    // The len <= 64 bits starting at pos as an integer whose bit 0 is bit
+    // pos, e.g. a field of a packed header. Throws std::out_of_range if
+    // pos + len > size() and std::invalid_argument if T has fewer than len
+    // bits.
+    template <typename T = std::uint64_t>
+    constexpr T extract(std::size_t pos, std::size_t len) const {
+        static_assert(std::is_unsigned_v<T> &&
+                          sizeof(T) <= sizeof(std::uint64_t),
+                      "extract requires an unsigned type of at most 64 bits");
+        check_range(pos, len, "extract");
+        check_field(len, 8 * sizeof(T), "extract");
+        return static_cast<T>(extract_bits(pos, len));
+    }
+
+    // A field at a constant position, a shift and a mask of one load
+    template <std::size_t Pos, std::size_t Len, typename T = std::uint64_t>
+    constexpr T extract() const noexcept {
+        static_assert(std::is_unsigned_v<T> &&
+                          sizeof(T) <= sizeof(std::uint64_t),
+                      "extract requires an unsigned type of at most 64 bits");
+        static_assert(Pos <= N && Len <= N - Pos, "field out of range");
+        static_assert(Len <= 8 * sizeof(T), "field wider than T");
+        return static_cast<T>(extract_bits(Pos, Len));
+    }
+
+    // Replaces the len <= 64 bits starting at pos by the low len bits of
+    // value, throwing as extract() does
+    constexpr bitset &insert(std::size_t pos, std::size_t len,
+                             std::uint64_t value) {
+        check_range(pos, len, "insert");
+        check_field(len, 64, "insert");
+        insert_bits(pos, len, value);
+        return *this;
+    }
+
+    template <std::size_t Pos, std::size_t Len>
+    constexpr bitset &insert(std::uint64_t value) noexcept {
+        static_assert(Pos <= N && Len <= N - Pos, "field out of range");
+        static_assert(Len <= 64, "field wider than 64 bits");
+        insert_bits(Pos, Len, value);
+        return *this;
+    }
+
     constexpr bitset &operator&=(const bitset &other) noexcept {
+        if (use_simd()) {
+            detail::dispatch::bit_and(
+                bytes(), bytes(), other.bytes(), sizeof m_data);
+            return *this;
+        }
         for (auto i = 0; i < s_num_words; i++) {
             m_data[i] &= other.m_data[i];
         }
@@ -268,6 +1539,11 @@ template <std::size_t N, typename Underlying = std::uint8_t> class bitset {
     }
 
     constexpr bitset &operator|=(const bitset &other) noexcept {
+        if (use_simd()) {
+            detail::dispatch::bit_or(
+                bytes(), bytes(), other.bytes(), sizeof m_data);
+            return *this;
+        }
         for (auto i = 0; i < s_num_words; i++) {
             m_data[i] |= other.m_data[i];
         }
@@ -275,21 +1551,45 @@ template <std::size_t N, typename Underlying = std::uint8_t> class bitset {
     }
 
     constexpr bitset &operator^=(const bitset &other) noexcept {
+        if (use_simd()) {
+            detail::dispatch::bit_xor(
+                bytes(), bytes(), other.bytes(), sizeof m_data);
+            return *this;
+        }
         for (auto i = 0; i < s_num_words; i++) {
             m_data[i] ^= other.m_data[i];
         }
         return *this;
     }
 
-    constexpr bitset operator~() const noexcept {
-        bitset other;
-        for (auto i = 0; i < s_num_words; i++) {
-            other.m_data[i] = ~m_data[i];
+    template <class Derived>
+    constexpr bitset &operator&=(const expr<Derived> &e) noexcept {
+        for (std::size_t i = 0; i < s_num_words; i++) {
+            m_data[i] &= static_cast<const Derived &>(e).word(i);
+        }
+        return *this;
+    }
+
+    template <class Derived>
+    constexpr bitset &operator|=(const expr<Derived> &e) noexcept {
+        for (std::size_t i = 0; i < s_num_words; i++) {
+            m_data[i] |= static_cast<const Derived &>(e).word(i);
         }
-        if (N % s_num_underlying_bits != 0) {
-            other.m_data[s_num_words - 1] &= s_last_word_mask;
+        m_data[s_num_words - 1] &= s_last_word_mask;
+        return *this;
+    }
+
+    template <class Derived>
+    constexpr bitset &operator^=(const expr<Derived> &e) noexcept {
+        for (std::size_t i = 0; i < s_num_words; i++) {
+            m_data[i] ^= static_cast<const Derived &>(e).word(i);
         }
-        return other;
+        m_data[s_num_words - 1] &= s_last_word_mask;
+        return *this;
+    }
+
+    constexpr not_expr<bitset> operator~() const noexcept {
+        return not_expr<bitset>(*this);
     }
 
     constexpr bitset operator<<(std::size_t shift) const noexcept {
@@ -304,6 +1604,16 @@ template <std::size_t N, typename Underlying = std::uint8_t> class bitset {
             reset();
             return *this;
         }
+        if (use_lane_shift()) {
+            store_lane(load_lane() << shift);
+            m_data[s_num_words - 1] &= s_last_word_mask;
+            return *this;
+        }
+        if (use_simd() && s_bytes_in_bit_order) {
+            detail::dispatch::shift_left(bytes(), sizeof m_data, shift);
+            m_data[s_num_words - 1] &= s_last_word_mask;
+            return *this;
+        }
 
         const std::size_t num_words_to_shift = shift / s_num_underlying_bits;
 
@@ -329,6 +1639,8 @@ template <std::size_t N, typename Underlying = std::uint8_t> class bitset {
             m_data[i] = 0;
         }
 
+        // and clear the bits shifted past N
+        m_data[s_num_words - 1] &= s_last_word_mask;
         return *this;
     }
 
@@ -344,6 +1656,14 @@ template <std::size_t N, typename Underlying = std::uint8_t> class bitset {
             reset();
             return *this;
         }
+        if (use_lane_shift()) {
+            store_lane(load_lane() >> shift);
+            return *this;
+        }
+        if (use_simd() && s_bytes_in_bit_order) {
+            detail::dispatch::shift_right(bytes(), sizeof m_data, shift);
+            return *this;
+        }
         const auto num_words_to_shift = shift / s_num_underlying_bits;
 
         // If the shift is exactly the size of a word
@@ -373,16 +1693,44 @@ template <std::size_t N, typename Underlying = std::uint8_t> class bitset {
         return *this;
     }
 
+    // Rotates the bits towards the last one (rotl) or the first one (rotr):
+    // the bits shifted out at one end come back in at the other
+    constexpr bitset &rotl(std::size_t shift) noexcept {
+        shift %= N;
+        if (shift != 0 && use_lane_shift()) {
+            const std::uint64_t lane = load_lane();
+            store_lane(lane << shift | lane >> (N - shift));
+            m_data[s_num_words - 1] &= s_last_word_mask;
+        } else if (shift != 0) {
+            bitset wrapped(*this);
+            wrapped >>= N - shift;
+            *this <<= shift;
+            *this |= wrapped;
+        }
+        return *this;
+    }
+
+    constexpr bitset &rotr(std::size_t shift) noexcept {
+        return rotl(N - shift % N);
+    }
+
     template <class CharT = char, class Traits = std::char_traits<CharT>,
               class Allocator = std::allocator<CharT>>
     std::basic_string<CharT, Traits, Allocator>
     to_string(CharT zero = CharT('0'), CharT one = CharT('1')) const {
-        std::basic_string<CharT, Traits, Allocator> str;
-        str.reserve(size());
-        for (auto i = size() - 1; i > 0; i--) {
-            str.append(1, this->operator[](i) ? one : zero);
+        std::basic_string<CharT, Traits, Allocator> str(N, zero);
+        if constexpr (s_text_kernels_v<CharT, Traits>) {
+            detail::dispatch::format_bits(
+                reinterpret_cast<unsigned char *>(str.data()), bytes(), N,
+                static_cast<unsigned char>(zero),
+                static_cast<unsigned char>(one));
+        } else {
+            for (std::size_t i = 0; i < N; i++) {
+                if ((m_data[underlying_index(i)] & mask(i)) != 0) {
+                    Traits::assign(str[N - 1 - i], one);
+                }
+            }
         }
-        str.append(1, this->operator[](0) ? one : zero);
         return str;
     }
 
@@ -454,48 +1802,126 @@ template <std::size_t N, typename Underlying = std::uint8_t> class bitset {
         return value;
     }
 
+    // The binary format of a bitset is byte_size() bytes, bit i being bit
+    // i % 8 of byte i / 8 and the bits above N zero. It is the same for every
+    // Underlying type and host, so bytes written by one bitset<N> can be read
+    // by any other.
+    static constexpr std::size_t byte_size() noexcept { return (N + 7) / 8; }
+
+    // The bits in the binary format, without copying. Only available where
+    // the words are stored in that order, i.e. on little-endian hosts or
+    // with single-byte words; use write_to elsewhere.
+    byte_span<const std::byte> as_bytes() const noexcept {
+        static_assert(s_bytes_in_bit_order,
+                      "as_bytes() needs little-endian words, use write_to()");
+        return {reinterpret_cast<const std::byte *>(m_data.data()),
+                byte_size()};
+    }
+
+    // Throws std::invalid_argument unless bytes holds byte_size() bytes. Bits
+    // above N in the last byte are ignored.
+    static bitset from_bytes(byte_span<const std::byte> bytes) {
+        if (bytes.size() != byte_size()) {
+            throw std::invalid_argument(
+                "from_bytes: expected " + std::to_string(byte_size()) +
+                " bytes, got " + std::to_string(bytes.size()));
+        }
+        bitset bits;
+        bits.read_from(bytes.data());
+        return bits;
+    }
+
+    // Writes the byte_size() bytes of the binary format to dst
+    void write_to(std::byte *dst) const noexcept {
+        if constexpr (s_bytes_in_bit_order) {
+            std::memcpy(dst, m_data.data(), byte_size());
+        } else {
+            for (std::size_t i = 0; i < byte_size(); i++) {
+                dst[i] = static_cast<std::byte>(
+                    m_data[i / sizeof(underlying_type_t)] >>
+                    (8 * (i % sizeof(underlying_type_t))));
+            }
+        }
+    }
+
+    // Replaces the bits with the byte_size() bytes of the binary format at src
+    void read_from(const std::byte *src) noexcept {
+        if constexpr (s_bytes_in_bit_order) {
+            std::memcpy(m_data.data(), src, byte_size());
+        } else {
+            m_data.fill(underlying_type_t{0});
+            for (std::size_t i = 0; i < byte_size(); i++) {
+                const auto byte = static_cast<underlying_type_t>(src[i]);
+                m_data[i / sizeof(underlying_type_t)] |=
+                    static_cast<underlying_type_t>(
+                        byte << (8 * (i % sizeof(underlying_type_t))));
+            }
+        }
+        m_data[s_num_words - 1] &= s_last_word_mask;
+    }
+
     constexpr bool operator==(const bitset &rhs) const noexcept {
+        if (use_simd()) {
+            return detail::dispatch::equal(bytes(), rhs.bytes(), sizeof m_data);
+        }
         for (auto i = 0; i < s_num_words; i++) {
             if (m_data[i] != rhs.m_data[i]) {
                 return false;
             }
         }
-        if constexpr (N % s_num_underlying_bits == 0) {
-            return true;
-        } else {
-            return m_data[s_num_words - 1] == rhs.m_data[s_num_words - 1];
-        }
+        return true;
     }
 
     constexpr bool operator!=(const bitset &rhs) const noexcept {
         return !(*this == rhs);
     }
 
-    friend constexpr bitset operator&(const bitset &lhs,
-                                      const bitset &rhs) noexcept {
-        bitset value;
-        for (auto i = 0; i < s_num_words; i++) {
-            value.m_data[i] = lhs.m_data[i] & rhs.m_data[i];
-        }
-        return value;
+    friend constexpr binary_expr<detail::and_op, bitset, bitset>
+    operator&(const bitset &lhs, const bitset &rhs) noexcept {
+        return {lhs, rhs};
     }
 
-    friend constexpr bitset operator|(const bitset &lhs,
-                                      const bitset &rhs) noexcept {
-        bitset value;
-        for (auto i = 0; i < s_num_words; i++) {
-            value.m_data[i] = lhs.m_data[i] | rhs.m_data[i];
-        }
-        return value;
+    template <class Lhs, class Rhs,
+              std::enable_if_t<is_expr_pair_v<Lhs, Rhs>, int> = 0>
+    friend constexpr binary_expr<detail::and_op, Lhs, Rhs>
+    operator&(const Lhs &lhs, const Rhs &rhs) noexcept {
+        return {lhs, rhs};
     }
 
-    friend constexpr bitset operator^(const bitset &lhs,
-                                      const bitset &rhs) noexcept {
-        bitset value;
-        for (auto i = 0; i < s_num_words; i++) {
-            value.m_data[i] = lhs.m_data[i] ^ rhs.m_data[i];
-        }
-        return value;
+    friend constexpr binary_expr<detail::or_op, bitset, bitset>
+    operator|(const bitset &lhs, const bitset &rhs) noexcept {
+        return {lhs, rhs};
+    }
+
+    template <class Lhs, class Rhs,
+              std::enable_if_t<is_expr_pair_v<Lhs, Rhs>, int> = 0>
+    friend constexpr binary_expr<detail::or_op, Lhs, Rhs>
+    operator|(const Lhs &lhs, const Rhs &rhs) noexcept {
+        return {lhs, rhs};
+    }
+
+    friend constexpr binary_expr<detail::xor_op, bitset, bitset>
+    operator^(const bitset &lhs, const bitset &rhs) noexcept {
+        return {lhs, rhs};
+    }
+
+    template <class Lhs, class Rhs,
+              std::enable_if_t<is_expr_pair_v<Lhs, Rhs>, int> = 0>
+    friend constexpr binary_expr<detail::xor_op, Lhs, Rhs>
+    operator^(const Lhs &lhs, const Rhs &rhs) noexcept {
+        return {lhs, rhs};
+    }
+
+    template <class Lhs, class Rhs,
+              std::enable_if_t<is_expr_v<Lhs> && is_expr_v<Rhs>, int> = 0>
+    friend constexpr bool operator==(const Lhs &lhs, const Rhs &rhs) noexcept {
+        return words_equal(lhs, rhs);
+    }
+
+    template <class Lhs, class Rhs,
+              std::enable_if_t<is_expr_v<Lhs> && is_expr_v<Rhs>, int> = 0>
+    friend constexpr bool operator!=(const Lhs &lhs, const Rhs &rhs) noexcept {
+        return !words_equal(lhs, rhs);
     }
 
     template <class CharT, class Traits>
@@ -506,36 +1932,117 @@ template <std::size_t N, typename Underlying = std::uint8_t> class bitset {
                    std::use_facet<std::ctype<CharT>>(os.getloc()).widen('1'));
     }
 
+    // Skips leading whitespace, then reads up to N zeros and ones straight
+    // from the stream buffer. A whitespace character or the end of the input
+    // ends the bitset early, which then holds the bits read so far as its
+    // lowest bits. Any other character is extracted and sets failbit, as
+    // does reading no character at all.
     template <class CharT, class Traits>
     friend std::basic_istream<CharT, Traits> &
     operator>>(std::basic_istream<CharT, Traits> &is, bitset &bits) {
-        int i{N - 1};
-        while (i >= 0) {
-            CharT input;
-            is >> input;
+        using access = detail::streambuf_access<CharT, Traits>;
+        const typename std::basic_istream<CharT, Traits>::sentry sentry(is);
+        if (!sentry) {
+            return is;
+        }
 
-            if (!is.good()) {
+        const CharT zero = is.widen('0');
+        const CharT one = is.widen('1');
+        std::basic_string<CharT, Traits> chars;
+        chars.reserve(N);
+        std::ios_base::iostate state = std::ios_base::goodbit;
+        auto &buf = *is.rdbuf();
+        while (chars.size() < N) {
+            const auto c = buf.sgetc();
+            if (Traits::eq_int_type(c, Traits::eof())) {
+                state |= std::ios_base::eofbit;
                 break;
             }
-            if (input == is.widen('0')) {
-                bits[i] = 0;
-            } else if (input == is.widen('1')) {
-                bits[i] = 1;
+            const CharT *first = access::next(buf);
+            const CharT *last = access::end(buf);
+            if (first == last) {
+                // An unbuffered streambuf has no get area to scan, so the
+                // character sgetc() returned is taken on its own
+                const CharT ch = Traits::to_char_type(c);
+                if (Traits::eq(ch, zero) || Traits::eq(ch, one)) {
+                    chars.push_back(ch);
+                    buf.sbumpc();
+                    continue;
+                }
+                if (!std::isspace(ch, is.getloc())) {
+                    buf.sbumpc();
+                    state |= std::ios_base::failbit;
+                }
+                break;
+            }
+            // Otherwise sgetc() has filled the get area, scanned in place
+            if (static_cast<std::size_t>(last - first) > N - chars.size()) {
+                last = first + (N - chars.size());
+            }
+            const CharT *p = first;
+            if constexpr (s_text_kernels_v<CharT, Traits>) {
+                p += detail::dispatch::span_bits(
+                    reinterpret_cast<const unsigned char *>(first),
+                    static_cast<std::size_t>(last - first),
+                    static_cast<unsigned char>(zero),
+                    static_cast<unsigned char>(one));
             } else {
-                is.setstate(std::ios_base::failbit);
+                while (p != last &&
+                       (Traits::eq(*p, zero) || Traits::eq(*p, one))) {
+                    ++p;
+                }
+            }
+            chars.append(first, p);
+            access::bump(buf, static_cast<int>(p - first));
+            if (p != last) {
+                if (!std::isspace(*p, is.getloc())) {
+                    buf.sbumpc();
+                    state |= std::ios_base::failbit;
+                }
                 break;
             }
-            --i;
         }
-        if (i >= 0) { // if incomplete read
-            bits >>= (i + 1);
+
+        // Every character is valid, so the parse cannot throw
+        bits.reset();
+        const std::size_t len = chars.size();
+        if (!bits.template parse_with_kernel<CharT, Traits>(chars.data(), len,
+                                                            zero, one)) {
+            for (std::size_t i = 0; i < len; i++) {
+                if (Traits::eq(chars[len - 1 - i], one)) {
+                    bits.m_data[underlying_index(i)] |= mask(i);
+                }
+            }
         }
+        if (N > 0 && chars.empty()) {
+            state |= std::ios_base::failbit;
+        }
+        is.setstate(state);
         return is;
     }
 
     friend struct std::hash<bitset>;
+    friend struct detail::bitset_access;
+};
+
+namespace detail {
+
+// Access to the words of a bitset for the other containers of this library
+struct bitset_access {
+    template <std::size_t N, typename Underlying>
+    static constexpr auto &words(bitset<N, Underlying> &bits) noexcept {
+        return bits.m_data;
+    }
+
+    template <std::size_t N, typename Underlying>
+    static constexpr const auto &
+    words(const bitset<N, Underlying> &bits) noexcept {
+        return bits.m_data;
+    }
 };
 
+} // namespace detail
+
 } // namespace nonstd
 
 namespace std {
@@ -544,17 +2051,7 @@ template <size_t N, typename Underlying>
 struct hash<nonstd::bitset<N, Underlying>> {
     constexpr size_t
     operator()(const nonstd::bitset<N, Underlying> &s) const noexcept {
-        if constexpr (N < (8 * sizeof(unsigned long long))) {
-            return hash<unsigned long long>()(s.to_ullong());
-        }
-
-        // boost::hash_combine algorithm
-        size_t value = hash<Underlying>()(s.m_data[0]);
-        for (auto i = 1; i < s.s_num_words; i++) {
-            value ^= hash<Underlying>()(s.m_data[i]) + 0x9e3779b9 +
-                     (value << 6) + (value >> 2);
-        }
-        return value;
+        return nonstd::detail::hash_words(s.m_data.data(), s.s_num_words, N);
     }
 };
 } // namespace std
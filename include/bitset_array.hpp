@@ -0,0 +1,280 @@
+#pragma once
+
+#include "bitset.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace nonstd {
+
+// A sequence of bitset<N, Underlying> rows stored column by column: 64-bit
+// word w of every row is kept together, so that the batched queries below
+// apply one word of the query to 4 or 8 rows per vector instruction instead
+// of looping over small bitsets one at a time.
+//
+// Words are taken from the binary format of the rows (see
+// bitset::write_to), so the layout is the same for every Underlying type.
+// The batched queries accept a thread count and split the rows into
+// contiguous blocks, one range of blocks per thread.
+template <std::size_t N, typename Underlying = std::uint8_t>
+class bitset_array {
+    static_assert(N > 0, "bitset_array requires at least one bit per row");
+
+  public:
+    using bitset_type = bitset<N, Underlying>;
+
+  private:
+    static constexpr std::size_t s_num_columns = (N + 63) / 64;
+
+    // Rows are processed in blocks whose counts stay in cache, and the
+    // capacity is a multiple of it so every column has whole blocks
+    static constexpr std::size_t s_block_rows = 256;
+
+    // Word w of row r is m_words[w * m_capacity + r]; rows past m_size are
+    // zero
+    std::vector<std::uint64_t> m_words;
+    std::size_t m_size{0};
+    std::size_t m_capacity{0};
+
+    using columns_t = std::array<std::uint64_t, s_num_columns>;
+
+    static columns_t to_columns(const bitset_type &bits) noexcept {
+        unsigned char bytes[8 * s_num_columns]{};
+        bits.write_to(reinterpret_cast<std::byte *>(bytes));
+        columns_t columns{};
+        for (std::size_t i = 0; i < sizeof bytes; i++) {
+            columns[i / 8] |= std::uint64_t{bytes[i]} << (8 * (i % 8));
+        }
+        return columns;
+    }
+
+    void check_row(std::size_t row, const char *what) const {
+        if (row >= m_size) {
+            throw std::out_of_range(std::string("bitset_array::") + what +
+                                    ": row " + std::to_string(row) +
+                                    " >= size() " + std::to_string(m_size));
+        }
+    }
+
+    // Calls fn(first, last) on contiguous ranges of whole blocks covering
+    // every row, on up to num_threads threads
+    template <class Fn>
+    void for_blocks(std::size_t num_threads, Fn fn) const {
+        const std::size_t num_blocks =
+            (m_size + s_block_rows - 1) / s_block_rows;
+        num_threads = std::max<std::size_t>(
+            1, std::min(num_threads, num_blocks));
+        if (num_threads == 1) {
+            fn(std::size_t{0}, num_blocks * s_block_rows);
+            return;
+        }
+        std::vector<std::thread> threads;
+        threads.reserve(num_threads - 1);
+        std::size_t first{0};
+        for (std::size_t t = 0; t < num_threads; t++) {
+            const std::size_t blocks =
+                num_blocks / num_threads + (t < num_blocks % num_threads);
+            const std::size_t last = first + blocks * s_block_rows;
+            if (t + 1 == num_threads) {
+                fn(first, last);
+            } else {
+                threads.emplace_back(fn, first, last);
+            }
+            first = last;
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+    }
+
+    // counts[r - first] = popcount(row r op operand) for rows [first, last)
+    template <bool Xor>
+    void count_rows(const columns_t &operand, std::size_t first,
+                    std::size_t last, std::uint64_t *counts) const noexcept {
+        std::fill(counts, counts + (last - first), std::uint64_t{0});
+        for (std::size_t w = 0; w < s_num_columns; w++) {
+            const std::uint64_t *column = &m_words[w * m_capacity + first];
+            if constexpr (Xor) {
+                detail::dispatch::column_count_xor(counts, column, operand[w],
+                                                   last - first);
+            } else {
+                detail::dispatch::column_count_and(counts, column, operand[w],
+                                                   last - first);
+            }
+        }
+    }
+
+  public:
+    bitset_array() = default;
+
+    // num_rows rows with every bit zero
+    explicit bitset_array(std::size_t num_rows) { resize(num_rows); }
+
+    std::size_t size() const noexcept { return m_size; }
+    bool empty() const noexcept { return m_size == 0; }
+    std::size_t capacity() const noexcept { return m_capacity; }
+
+    void reserve(std::size_t num_rows) {
+        if (num_rows <= m_capacity) {
+            return;
+        }
+        const std::size_t capacity =
+            (num_rows + s_block_rows - 1) / s_block_rows * s_block_rows;
+        std::vector<std::uint64_t> words(s_num_columns * capacity);
+        for (std::size_t w = 0; w < s_num_columns; w++) {
+            std::copy_n(m_words.begin() + w * m_capacity, m_size,
+                        words.begin() + w * capacity);
+        }
+        m_words = std::move(words);
+        m_capacity = capacity;
+    }
+
+    // New rows are zero
+    void resize(std::size_t num_rows) {
+        reserve(num_rows);
+        for (std::size_t w = 0; w < s_num_columns && num_rows < m_size; w++) {
+            std::fill_n(m_words.begin() + w * m_capacity + num_rows,
+                        m_size - num_rows, std::uint64_t{0});
+        }
+        m_size = num_rows;
+    }
+
+    void clear() noexcept { resize(0); }
+
+    void push_back(const bitset_type &bits) {
+        if (m_size == m_capacity) {
+            reserve(std::max(2 * m_capacity, s_block_rows));
+        }
+        m_size++;
+        assign(m_size - 1, bits);
+    }
+
+    // A copy of row r
+    bitset_type row(std::size_t r) const {
+        check_row(r, "row");
+        unsigned char bytes[8 * s_num_columns];
+        for (std::size_t w = 0; w < s_num_columns; w++) {
+            const std::uint64_t word = m_words[w * m_capacity + r];
+            for (std::size_t i = 0; i < 8; i++) {
+                bytes[8 * w + i] = static_cast<unsigned char>(word >> (8 * i));
+            }
+        }
+        bitset_type bits;
+        bits.read_from(reinterpret_cast<const std::byte *>(bytes));
+        return bits;
+    }
+
+    bitset_type operator[](std::size_t r) const { return row(r); }
+
+    void assign(std::size_t r, const bitset_type &bits) {
+        check_row(r, "assign");
+        const auto columns = to_columns(bits);
+        for (std::size_t w = 0; w < s_num_columns; w++) {
+            m_words[w * m_capacity + r] = columns[w];
+        }
+    }
+
+    bool test(std::size_t r, std::size_t pos) const {
+        check_row(r, "test");
+        if (pos >= N) {
+            throw std::out_of_range("bitset_array::test: pos out of range");
+        }
+        return (m_words[pos / 64 * m_capacity + r] >> (pos % 64) & 1) != 0;
+    }
+
+    // out[r] = (row r & mask).count() for every row; out must hold size()
+    // elements
+    void and_count_all(const bitset_type &mask, std::size_t *out,
+                       std::size_t num_threads = 1) const {
+        const auto operand = to_columns(mask);
+        for_blocks(num_threads, [&](std::size_t first, std::size_t last) {
+            std::uint64_t counts[s_block_rows];
+            for (std::size_t r = first; r < last && r < m_size;
+                 r += s_block_rows) {
+                count_rows<false>(operand, r, r + s_block_rows, counts);
+                std::copy_n(counts, std::min(s_block_rows, m_size - r),
+                            out + r);
+            }
+        });
+    }
+
+    std::vector<std::size_t> and_count_all(const bitset_type &mask,
+                                           std::size_t num_threads = 1) const {
+        std::vector<std::size_t> out(m_size);
+        and_count_all(mask, out.data(), num_threads);
+        return out;
+    }
+
+    // The indices of the rows with no bit outside mask, in increasing order
+    std::vector<std::size_t>
+    filter_subset_of(const bitset_type &mask,
+                     std::size_t num_threads = 1) const {
+        const auto operand = to_columns(mask);
+        std::vector<unsigned char> match(m_size);
+        for_blocks(num_threads, [&](std::size_t first, std::size_t last) {
+            std::uint64_t outside[s_block_rows];
+            for (std::size_t r = first; r < last && r < m_size;
+                 r += s_block_rows) {
+                std::fill_n(outside, s_block_rows, std::uint64_t{0});
+                for (std::size_t w = 0; w < s_num_columns; w++) {
+                    const std::uint64_t *column = &m_words[w * m_capacity + r];
+                    const std::uint64_t not_mask = ~operand[w];
+                    for (std::size_t i = 0; i < s_block_rows; i++) {
+                        outside[i] |= column[i] & not_mask;
+                    }
+                }
+                const std::size_t num_rows = std::min(s_block_rows, m_size - r);
+                for (std::size_t i = 0; i < num_rows; i++) {
+                    match[r + i] = outside[i] == 0;
+                }
+            }
+        });
+        std::vector<std::size_t> rows;
+        for (std::size_t r = 0; r < m_size; r++) {
+            if (match[r]) {
+                rows.push_back(r);
+            }
+        }
+        return rows;
+    }
+
+    // The indices of the k rows closest to query in Hamming distance, the
+    // closest first and ties by index, with their distances
+    std::vector<std::pair<std::size_t, std::size_t>>
+    hamming_top_k(const bitset_type &query, std::size_t k,
+                  std::size_t num_threads = 1) const {
+        const auto operand = to_columns(query);
+        k = std::min(k, m_size);
+        using entry_t = std::pair<std::size_t, std::size_t>; // distance, row
+        std::vector<entry_t> distances(m_size);
+        for_blocks(num_threads, [&](std::size_t first, std::size_t last) {
+            std::uint64_t counts[s_block_rows];
+            for (std::size_t r = first; r < last && r < m_size;
+                 r += s_block_rows) {
+                count_rows<true>(operand, r, r + s_block_rows, counts);
+                const std::size_t num_rows = std::min(s_block_rows, m_size - r);
+                for (std::size_t i = 0; i < num_rows; i++) {
+                    distances[r + i] = {static_cast<std::size_t>(counts[i]),
+                                        r + i};
+                }
+            }
+        });
+        std::partial_sort(distances.begin(), distances.begin() + k,
+                          distances.end());
+        std::vector<std::pair<std::size_t, std::size_t>> top(k);
+        for (std::size_t i = 0; i < k; i++) {
+            top[i] = {distances[i].second, distances[i].first};
+        }
+        return top;
+    }
+};
+
+} // namespace nonstd
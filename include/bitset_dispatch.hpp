@@ -0,0 +1,386 @@
+#pragma once
+
+#include "bitset_simd.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+
+// Runtime selection of the bulk kernels. On x86 with GCC or Clang the kernels
+// are additionally built for POPCNT, AVX2 and AVX-512 hosts; the CPU is probed
+// once, on first use, and the best supported set is cached in a table of
+// function pointers. Everywhere else the table simply holds the native
+// kernels.
+//
+// The indirect call only pays off for large buffers, so below k_min_bytes the
+// front-end functions at the bottom call the inline native kernels instead.
+// Define NONSTD_BITSET_NO_DISPATCH to always use the native kernels.
+
+#if !defined(NONSTD_BITSET_NO_DISPATCH) && defined(__GNUC__) &&                \
+    (defined(__x86_64__) || defined(__i386__))
+#define NONSTD_BITSET_DISPATCH 1
+#else
+#define NONSTD_BITSET_DISPATCH 0
+#endif
+
+#if NONSTD_BITSET_DISPATCH
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("sse4.2,popcnt"))),        \
+                             apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("sse4.2,popcnt")
+#endif
+#define NONSTD_SIMD_LEVEL 2
+#define NONSTD_SIMD_NAMESPACE popcnt
+#include "bitset_simd_kernels.inc"
+#undef NONSTD_SIMD_NAMESPACE
+#undef NONSTD_SIMD_LEVEL
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+#if defined(__clang__)
+#pragma clang attribute push(                                                  \
+    __attribute__((target("avx2,bmi,bmi2,popcnt"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx2,bmi,bmi2,popcnt")
+#endif
+#define NONSTD_SIMD_LEVEL 3
+#define NONSTD_SIMD_NAMESPACE avx2
+#include "bitset_simd_kernels.inc"
+#undef NONSTD_SIMD_NAMESPACE
+#undef NONSTD_SIMD_LEVEL
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+#if defined(__clang__)
+#pragma clang attribute push(                                                  \
+    __attribute__((target("avx512f,avx512bw,avx2,bmi,bmi2,popcnt"))),         \
+    apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx512bw,avx2,bmi,bmi2,popcnt")
+#endif
+#define NONSTD_SIMD_LEVEL 4
+#define NONSTD_SIMD_NAMESPACE avx512
+#include "bitset_simd_kernels.inc"
+#undef NONSTD_SIMD_NAMESPACE
+#undef NONSTD_SIMD_LEVEL
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+#endif // NONSTD_BITSET_DISPATCH
+
+namespace nonstd::detail::dispatch {
+
+// Buffers of at least this many bytes go through the function pointer table
+inline constexpr std::size_t k_min_bytes{256};
+
+// Without POPCNT the native kernels count bits in software, so the counting
+// kernels go through the table much sooner
+inline constexpr std::size_t k_min_count_bytes{32};
+
+enum class isa { native, popcnt, avx2, avx512 };
+
+struct kernel_table {
+    std::size_t (*count)(const unsigned char *, std::size_t) noexcept;
+    void (*bit_and)(unsigned char *, const unsigned char *,
+                    const unsigned char *, std::size_t) noexcept;
+    void (*bit_or)(unsigned char *, const unsigned char *,
+                   const unsigned char *, std::size_t) noexcept;
+    void (*bit_xor)(unsigned char *, const unsigned char *,
+                    const unsigned char *, std::size_t) noexcept;
+    void (*invert)(unsigned char *, const unsigned char *,
+                   std::size_t) noexcept;
+    bool (*equal)(const unsigned char *, const unsigned char *,
+                  std::size_t) noexcept;
+    bool (*any)(const unsigned char *, std::size_t) noexcept;
+    bool (*all_ones)(const unsigned char *, std::size_t) noexcept;
+    void (*shift_left)(unsigned char *, std::size_t, std::size_t) noexcept;
+    void (*shift_right)(unsigned char *, std::size_t, std::size_t) noexcept;
+    std::size_t (*find_first)(const unsigned char *, std::size_t) noexcept;
+    std::size_t (*count_and)(const unsigned char *, const unsigned char *,
+                             std::size_t) noexcept;
+    std::size_t (*count_or)(const unsigned char *, const unsigned char *,
+                            std::size_t) noexcept;
+    std::size_t (*count_xor)(const unsigned char *, const unsigned char *,
+                             std::size_t) noexcept;
+    std::size_t (*count_and_not)(const unsigned char *, const unsigned char *,
+                                 std::size_t) noexcept;
+    bool (*any_and)(const unsigned char *, const unsigned char *,
+                    std::size_t) noexcept;
+    bool (*any_and_not)(const unsigned char *, const unsigned char *,
+                        std::size_t) noexcept;
+    void (*format_bits)(unsigned char *, const unsigned char *, std::size_t,
+                        unsigned char, unsigned char) noexcept;
+    std::size_t (*parse_bits)(unsigned char *, const unsigned char *,
+                              std::size_t, unsigned char,
+                              unsigned char) noexcept;
+    std::size_t (*span_bits)(const unsigned char *, std::size_t, unsigned char,
+                             unsigned char) noexcept;
+    void (*column_count_and)(std::uint64_t *, const std::uint64_t *,
+                             std::uint64_t, std::size_t) noexcept;
+    void (*column_count_xor)(std::uint64_t *, const std::uint64_t *,
+                             std::uint64_t, std::size_t) noexcept;
+};
+
+#define NONSTD_KERNEL_TABLE(ns)                                                \
+    kernel_table {                                                             \
+        &simd::ns::count, &simd::ns::transform<simd::ns::bit_and>,             \
+            &simd::ns::transform<simd::ns::bit_or>,                            \
+            &simd::ns::transform<simd::ns::bit_xor>, &simd::ns::invert,        \
+            &simd::ns::equal, &simd::ns::any, &simd::ns::all_ones,             \
+            &simd::ns::shift_left, &simd::ns::shift_right,                     \
+            &simd::ns::find_first,                                             \
+            &simd::ns::transform_count<simd::ns::bit_and>,                     \
+            &simd::ns::transform_count<simd::ns::bit_or>,                      \
+            &simd::ns::transform_count<simd::ns::bit_xor>,                     \
+            &simd::ns::transform_count<simd::ns::bit_and_not>,                 \
+            &simd::ns::transform_any<simd::ns::bit_and>,                       \
+            &simd::ns::transform_any<simd::ns::bit_and_not>,                   \
+            &simd::ns::format_bits, &simd::ns::parse_bits,                     \
+            &simd::ns::span_bits,                                              \
+            &simd::ns::column_count<simd::ns::bit_and>,                        \
+            &simd::ns::column_count<simd::ns::bit_xor>                         \
+    }
+
+inline bool supported(isa target) noexcept {
+#if NONSTD_BITSET_DISPATCH
+    __builtin_cpu_init();
+    switch (target) {
+    case isa::native:
+        return true;
+    case isa::popcnt:
+        return __builtin_cpu_supports("sse4.2") &&
+               __builtin_cpu_supports("popcnt");
+    case isa::avx2:
+        return __builtin_cpu_supports("avx2") &&
+               __builtin_cpu_supports("bmi") &&
+               __builtin_cpu_supports("bmi2") &&
+               __builtin_cpu_supports("popcnt");
+    case isa::avx512:
+        return supported(isa::avx2) && __builtin_cpu_supports("avx512f") &&
+               __builtin_cpu_supports("avx512bw");
+    }
+    return false;
+#else
+    return target == isa::native;
+#endif
+}
+
+inline isa best_supported_isa() noexcept {
+    for (auto target : {isa::avx512, isa::avx2, isa::popcnt}) {
+        if (supported(target)) {
+            return target;
+        }
+    }
+    return isa::native;
+}
+
+// The kernels for a specific instruction set, which must be supported
+inline const kernel_table &kernels_for(isa target) noexcept {
+    static constexpr kernel_table native = NONSTD_KERNEL_TABLE(native);
+#if NONSTD_BITSET_DISPATCH
+    static constexpr kernel_table popcnt = NONSTD_KERNEL_TABLE(popcnt);
+    static constexpr kernel_table avx2 = NONSTD_KERNEL_TABLE(avx2);
+    static constexpr kernel_table avx512 = NONSTD_KERNEL_TABLE(avx512);
+    switch (target) {
+    case isa::native:
+        return native;
+    case isa::popcnt:
+        return popcnt;
+    case isa::avx2:
+        return avx2;
+    case isa::avx512:
+        return avx512;
+    }
+#else
+    static_cast<void>(target);
+#endif
+    return native;
+}
+
+#undef NONSTD_KERNEL_TABLE
+
+inline const kernel_table &kernels() noexcept {
+    static const kernel_table &table = kernels_for(best_supported_isa());
+    return table;
+}
+
+inline std::size_t count(const unsigned char *data,
+                         std::size_t num_bytes) noexcept {
+    return num_bytes >= k_min_count_bytes
+               ? kernels().count(data, num_bytes)
+               : simd::native::count(data, num_bytes);
+}
+
+inline void bit_and(unsigned char *dst, const unsigned char *lhs,
+                    const unsigned char *rhs, std::size_t num_bytes) noexcept {
+    if (num_bytes >= k_min_bytes) {
+        kernels().bit_and(dst, lhs, rhs, num_bytes);
+    } else {
+        simd::native::transform<simd::native::bit_and>(dst, lhs, rhs,
+                                                       num_bytes);
+    }
+}
+
+inline void bit_or(unsigned char *dst, const unsigned char *lhs,
+                   const unsigned char *rhs, std::size_t num_bytes) noexcept {
+    if (num_bytes >= k_min_bytes) {
+        kernels().bit_or(dst, lhs, rhs, num_bytes);
+    } else {
+        simd::native::transform<simd::native::bit_or>(dst, lhs, rhs,
+                                                      num_bytes);
+    }
+}
+
+inline void bit_xor(unsigned char *dst, const unsigned char *lhs,
+                    const unsigned char *rhs, std::size_t num_bytes) noexcept {
+    if (num_bytes >= k_min_bytes) {
+        kernels().bit_xor(dst, lhs, rhs, num_bytes);
+    } else {
+        simd::native::transform<simd::native::bit_xor>(dst, lhs, rhs,
+                                                       num_bytes);
+    }
+}
+
+inline void invert(unsigned char *dst, const unsigned char *src,
+                   std::size_t num_bytes) noexcept {
+    if (num_bytes >= k_min_bytes) {
+        kernels().invert(dst, src, num_bytes);
+    } else {
+        simd::native::invert(dst, src, num_bytes);
+    }
+}
+
+inline bool equal(const unsigned char *lhs, const unsigned char *rhs,
+                  std::size_t num_bytes) noexcept {
+    return num_bytes >= k_min_bytes ? kernels().equal(lhs, rhs, num_bytes)
+                                    : simd::native::equal(lhs, rhs, num_bytes);
+}
+
+inline bool any(const unsigned char *data, std::size_t num_bytes) noexcept {
+    return num_bytes >= k_min_bytes ? kernels().any(data, num_bytes)
+                                    : simd::native::any(data, num_bytes);
+}
+
+inline bool all_ones(const unsigned char *data,
+                     std::size_t num_bytes) noexcept {
+    return num_bytes >= k_min_bytes ? kernels().all_ones(data, num_bytes)
+                                    : simd::native::all_ones(data, num_bytes);
+}
+
+inline void shift_left(unsigned char *data, std::size_t num_bytes,
+                       std::size_t shift) noexcept {
+    if (num_bytes >= k_min_bytes) {
+        kernels().shift_left(data, num_bytes, shift);
+    } else {
+        simd::native::shift_left(data, num_bytes, shift);
+    }
+}
+
+inline void shift_right(unsigned char *data, std::size_t num_bytes,
+                        std::size_t shift) noexcept {
+    if (num_bytes >= k_min_bytes) {
+        kernels().shift_right(data, num_bytes, shift);
+    } else {
+        simd::native::shift_right(data, num_bytes, shift);
+    }
+}
+
+inline std::size_t find_first(const unsigned char *data,
+                              std::size_t num_bytes) noexcept {
+    return num_bytes >= k_min_bytes ? kernels().find_first(data, num_bytes)
+                                    : simd::native::find_first(data, num_bytes);
+}
+
+// The text kernels take one character per bit, so the threshold applies to
+// the number of characters
+inline void format_bits(unsigned char *dst, const unsigned char *src,
+                        std::size_t num_bits, unsigned char zero,
+                        unsigned char one) noexcept {
+    if (num_bits >= k_min_bytes) {
+        kernels().format_bits(dst, src, num_bits, zero, one);
+    } else {
+        simd::native::format_bits(dst, src, num_bits, zero, one);
+    }
+}
+
+inline std::size_t parse_bits(unsigned char *dst, const unsigned char *src,
+                              std::size_t num_chars, unsigned char zero,
+                              unsigned char one) noexcept {
+    return num_chars >= k_min_bytes
+               ? kernels().parse_bits(dst, src, num_chars, zero, one)
+               : simd::native::parse_bits(dst, src, num_chars, zero, one);
+}
+
+inline std::size_t span_bits(const unsigned char *src, std::size_t num_chars,
+                             unsigned char zero, unsigned char one) noexcept {
+    return num_chars >= k_min_bytes
+               ? kernels().span_bits(src, num_chars, zero, one)
+               : simd::native::span_bits(src, num_chars, zero, one);
+}
+
+// counts[r] += popcount(column[r] op operand) over num_rows 64-bit words
+inline void column_count_and(std::uint64_t *counts,
+                             const std::uint64_t *column,
+                             std::uint64_t operand,
+                             std::size_t num_rows) noexcept {
+    if (num_rows * sizeof(std::uint64_t) >= k_min_count_bytes) {
+        kernels().column_count_and(counts, column, operand, num_rows);
+    } else {
+        simd::native::column_count<simd::native::bit_and>(counts, column,
+                                                          operand, num_rows);
+    }
+}
+
+inline void column_count_xor(std::uint64_t *counts,
+                             const std::uint64_t *column,
+                             std::uint64_t operand,
+                             std::size_t num_rows) noexcept {
+    if (num_rows * sizeof(std::uint64_t) >= k_min_count_bytes) {
+        kernels().column_count_xor(counts, column, operand, num_rows);
+    } else {
+        simd::native::column_count<simd::native::bit_xor>(counts, column,
+                                                          operand, num_rows);
+    }
+}
+
+// The fused kernels below compute a reduction of lhs op rhs in one pass,
+// without storing the intermediate result. and_not is lhs & ~rhs.
+#define NONSTD_BINARY_KERNEL(name, result, kernel, min_bytes)                  \
+    inline result name(const unsigned char *lhs, const unsigned char *rhs,     \
+                       std::size_t num_bytes) noexcept {                       \
+        return num_bytes >= min_bytes                                          \
+                   ? kernels().name(lhs, rhs, num_bytes)                       \
+                   : simd::native::kernel(lhs, rhs, num_bytes);                \
+    }
+
+NONSTD_BINARY_KERNEL(count_and, std::size_t,
+                     transform_count<simd::native::bit_and>, k_min_count_bytes)
+NONSTD_BINARY_KERNEL(count_or, std::size_t,
+                     transform_count<simd::native::bit_or>, k_min_count_bytes)
+NONSTD_BINARY_KERNEL(count_xor, std::size_t,
+                     transform_count<simd::native::bit_xor>, k_min_count_bytes)
+NONSTD_BINARY_KERNEL(count_and_not, std::size_t,
+                     transform_count<simd::native::bit_and_not>,
+                     k_min_count_bytes)
+NONSTD_BINARY_KERNEL(any_and, bool, transform_any<simd::native::bit_and>,
+                     k_min_bytes)
+NONSTD_BINARY_KERNEL(any_and_not, bool,
+                     transform_any<simd::native::bit_and_not>, k_min_bytes)
+
+#undef NONSTD_BINARY_KERNEL
+
+} // namespace nonstd::detail::dispatch
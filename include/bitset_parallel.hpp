@@ -0,0 +1,507 @@
+#pragma once
+
+#include "bitset.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// <execution> is opt-in: with libstdc++ it pulls in TBB, which must then be
+// linked even if no parallel policy is used
+#ifdef NONSTD_BITSET_STD_EXECUTION
+#include <execution>
+#endif
+
+namespace nonstd {
+
+// Runs tasks on a fixed set of worker threads. bulk(n, fn) calls fn(i) for
+// every i < n, on the workers and on the calling thread, and returns once
+// every call has. fn must not throw.
+class thread_pool {
+    std::vector<std::thread> m_workers;
+
+    // Serializes calls to bulk() from different threads
+    std::mutex m_bulk_mutex;
+
+    // Guards everything below but m_next
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    std::uint64_t m_generation{0};
+    std::size_t m_active{0};
+    bool m_stop{false};
+
+    void (*m_invoke)(void *, std::size_t){nullptr};
+    void *m_fn{nullptr};
+    std::size_t m_num_tasks{0};
+    std::atomic<std::size_t> m_next{0};
+
+    void run_tasks() noexcept {
+        for (std::size_t i; (i = m_next.fetch_add(1)) < m_num_tasks;) {
+            m_invoke(m_fn, i);
+        }
+    }
+
+    void work() noexcept {
+        std::uint64_t generation{0};
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true) {
+            m_wake.wait(lock, [&] {
+                return m_stop || m_generation != generation;
+            });
+            if (m_stop) {
+                return;
+            }
+            generation = m_generation;
+            lock.unlock();
+            run_tasks();
+            lock.lock();
+            // Every worker checks in, so none can still be reading the task
+            // once bulk() returns
+            if (--m_active == 0) {
+                m_done.notify_one();
+            }
+        }
+    }
+
+  public:
+    // num_threads threads in total, counting the one calling bulk()
+    explicit thread_pool(
+        std::size_t num_threads = std::thread::hardware_concurrency()) {
+        for (std::size_t i = 1; i < num_threads; i++) {
+            m_workers.emplace_back([this] { work(); });
+        }
+    }
+
+    thread_pool(const thread_pool &) = delete;
+    thread_pool &operator=(const thread_pool &) = delete;
+
+    ~thread_pool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wake.notify_all();
+        for (auto &worker : m_workers) {
+            worker.join();
+        }
+    }
+
+    std::size_t concurrency() const noexcept { return m_workers.size() + 1; }
+
+    template <class Fn> void bulk(std::size_t n, Fn fn) {
+        if (m_workers.empty() || n <= 1) {
+            for (std::size_t i = 0; i < n; i++) {
+                fn(i);
+            }
+            return;
+        }
+        std::lock_guard<std::mutex> bulk_lock(m_bulk_mutex);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_invoke = [](void *f, std::size_t i) {
+                (*static_cast<Fn *>(f))(i);
+            };
+            m_fn = &fn;
+            m_num_tasks = n;
+            m_next = 0;
+            m_active = m_workers.size();
+            m_generation++;
+        }
+        m_wake.notify_all();
+        run_tasks();
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.wait(lock, [&] { return m_active == 0; });
+    }
+};
+
+#ifdef NONSTD_BITSET_STD_EXECUTION
+// Runs the tasks of bulk() through a standard execution policy, e.g.
+// policy_executor(std::execution::par)
+template <class Policy> class policy_executor {
+    Policy m_policy;
+
+  public:
+    explicit policy_executor(Policy policy) : m_policy(policy) {}
+
+    std::size_t concurrency() const noexcept {
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    template <class Fn> void bulk(std::size_t n, Fn fn) {
+        std::vector<std::size_t> tasks(n);
+        for (std::size_t i = 0; i < n; i++) {
+            tasks[i] = i;
+        }
+        std::for_each(m_policy, tasks.begin(), tasks.end(), fn);
+    }
+};
+#endif
+
+// Bulk operations on a bitset split across the threads of an executor: any
+// object with
+//
+//   std::size_t concurrency() const;  // the number of tasks run at once
+//   template <class Fn> void bulk(std::size_t n, Fn fn);  // see thread_pool
+//
+// such as thread_pool or policy_executor. Each task works on a contiguous
+// chunk of the words, with chunk boundaries on cache lines so that no two
+// tasks write the same line. Bitsets too small for two chunks of
+// k_min_chunk_bytes are processed serially by the member functions.
+namespace parallel {
+
+inline constexpr std::size_t k_min_chunk_bytes{std::size_t{1} << 18};
+inline constexpr std::size_t k_cache_line_bytes{64};
+
+namespace detail {
+
+// The number of chunks to split num_bytes into; 1 means serial
+template <class Executor>
+std::size_t num_chunks(const Executor &ex, std::size_t num_bytes) noexcept {
+    return std::max<std::size_t>(
+        1, std::min(ex.concurrency(), num_bytes / k_min_chunk_bytes));
+}
+
+// Calls fn(chunk, first, last) for num_chunks byte ranges covering
+// [0, num_bytes) of the memory at base, with every inner boundary on a cache
+// line (and therefore on a word)
+template <class Executor, class Fn>
+void for_each_chunk(Executor &ex, const void *base, std::size_t num_bytes,
+                    std::size_t num_chunks, Fn fn) {
+    const auto address = reinterpret_cast<std::uintptr_t>(base);
+    const auto boundary = [&](std::size_t i) {
+        if (i == 0 || i == num_chunks) {
+            return i == 0 ? 0 : num_bytes;
+        }
+        const std::size_t offset = num_bytes / num_chunks * i;
+        return offset - (address + offset) % k_cache_line_bytes;
+    };
+    ex.bulk(num_chunks, [&](std::size_t i) {
+        fn(i, boundary(i), boundary(i + 1));
+    });
+}
+
+inline std::uint64_t load64(const unsigned char *p) noexcept {
+    std::uint64_t value;
+    std::memcpy(&value, p, sizeof value);
+    return value;
+}
+
+inline void store64(unsigned char *p, std::uint64_t value) noexcept {
+    std::memcpy(p, &value, sizeof value);
+}
+
+// Bytes [first, last) of src, in bit order, shifted left by shift bits: a
+// funnel shift of 64-bit little-endian lanes, with the bytes whose source
+// straddles either end done one at a time
+inline void shift_left_range(unsigned char *dst, const unsigned char *src,
+                             std::size_t first, std::size_t last,
+                             std::size_t shift) noexcept {
+    const std::size_t q = shift / 8;
+    const unsigned r = shift % 8;
+    const auto shifted = [&](std::size_t i) {
+        const unsigned lo = i >= q ? src[i - q] : 0;
+        const unsigned below = i >= q + 1 ? src[i - q - 1] : 0;
+        return static_cast<unsigned char>(lo << r | below >> (8 - r));
+    };
+    std::size_t i = first;
+    for (; i < last && i < q + 1; i++) {
+        dst[i] = shifted(i);
+    }
+    for (; i + 8 <= last; i += 8) {
+        const unsigned below = src[i - q - 1];
+        store64(dst + i, load64(src + i - q) << r | below >> (8 - r));
+    }
+    for (; i < last; i++) {
+        dst[i] = shifted(i);
+    }
+}
+
+// Bytes [first, last) of the num_bytes bytes of src shifted right, towards
+// bit 0
+inline void shift_right_range(unsigned char *dst, const unsigned char *src,
+                              std::size_t num_bytes, std::size_t first,
+                              std::size_t last, std::size_t shift) noexcept {
+    const std::size_t q = shift / 8;
+    const unsigned r = shift % 8;
+    const auto shifted = [&](std::size_t i) {
+        const unsigned hi = i + q < num_bytes ? src[i + q] : 0;
+        const unsigned above = i + q + 1 < num_bytes ? src[i + q + 1] : 0;
+        return static_cast<unsigned char>(hi >> r | above << (8 - r));
+    };
+    std::size_t i = first;
+    for (; i + 8 <= last && i + q + 9 <= num_bytes; i += 8) {
+        const std::uint64_t above = src[i + q + 8];
+        store64(dst + i, load64(src + i + q) >> r | above << (63 - r) << 1);
+    }
+    for (; i < last; i++) {
+        dst[i] = shifted(i);
+    }
+}
+
+template <std::size_t N, typename Underlying>
+unsigned char *bytes(bitset<N, Underlying> &bits) noexcept {
+    return reinterpret_cast<unsigned char *>(
+        nonstd::detail::bitset_access::words(bits).data());
+}
+
+template <std::size_t N, typename Underlying>
+const unsigned char *bytes(const bitset<N, Underlying> &bits) noexcept {
+    return reinterpret_cast<const unsigned char *>(
+        nonstd::detail::bitset_access::words(bits).data());
+}
+
+template <std::size_t N, typename Underlying>
+constexpr std::size_t num_bytes() noexcept {
+    constexpr std::size_t kWordBits = 8 * sizeof(Underlying);
+    return (N + kWordBits - 1) / kWordBits * sizeof(Underlying);
+}
+
+// Applies op(dst, lhs, rhs, num_bytes), one of the dispatch kernels, to
+// every chunk of lhs and rhs
+template <class Executor, std::size_t N, typename Underlying, class Op>
+bitset<N, Underlying> &transform(Executor &ex, bitset<N, Underlying> &lhs,
+                                 const bitset<N, Underlying> &rhs, Op op) {
+    constexpr std::size_t kBytes = num_bytes<N, Underlying>();
+    unsigned char *dst = bytes(lhs);
+    const unsigned char *src = bytes(rhs);
+    for_each_chunk(ex, dst, kBytes, num_chunks(ex, kBytes),
+                   [&](std::size_t, std::size_t first, std::size_t last) {
+                       op(dst + first, dst + first, src + first, last - first);
+                   });
+    return lhs;
+}
+
+} // namespace detail
+
+template <class Executor, std::size_t N, typename Underlying>
+std::size_t count(Executor &&ex, const bitset<N, Underlying> &bits) {
+    constexpr std::size_t kBytes = detail::num_bytes<N, Underlying>();
+    const std::size_t chunks = detail::num_chunks(ex, kBytes);
+    if (chunks == 1) {
+        return bits.count();
+    }
+    const unsigned char *data = detail::bytes(bits);
+    std::vector<std::size_t> counts(chunks);
+    detail::for_each_chunk(
+        ex, data, kBytes, chunks,
+        [&](std::size_t i, std::size_t first, std::size_t last) {
+            counts[i] = nonstd::detail::dispatch::count(data + first,
+                                                        last - first);
+        });
+    std::size_t total{0};
+    for (const auto c : counts) {
+        total += c;
+    }
+    return total;
+}
+
+template <class Executor, std::size_t N, typename Underlying>
+bool any(Executor &&ex, const bitset<N, Underlying> &bits) {
+    constexpr std::size_t kBytes = detail::num_bytes<N, Underlying>();
+    const std::size_t chunks = detail::num_chunks(ex, kBytes);
+    if (chunks == 1) {
+        return bits.any();
+    }
+    const unsigned char *data = detail::bytes(bits);
+    std::vector<unsigned char> found(chunks);
+    detail::for_each_chunk(
+        ex, data, kBytes, chunks,
+        [&](std::size_t i, std::size_t first, std::size_t last) {
+            found[i] = nonstd::detail::dispatch::any(data + first,
+                                                     last - first);
+        });
+    return std::find(found.begin(), found.end(), 1) != found.end();
+}
+
+template <class Executor, std::size_t N, typename Underlying>
+bool none(Executor &&ex, const bitset<N, Underlying> &bits) {
+    return !parallel::any(ex, bits);
+}
+
+template <class Executor, std::size_t N, typename Underlying>
+bool all(Executor &&ex, const bitset<N, Underlying> &bits) {
+    // Every word but the last is all ones, and the last one holds the rest
+    constexpr std::size_t kWordBits = 8 * sizeof(Underlying);
+    constexpr std::size_t kLeadingBytes =
+        detail::num_bytes<N, Underlying>() - sizeof(Underlying);
+    const std::size_t chunks = detail::num_chunks(ex, kLeadingBytes);
+    if (chunks == 1) {
+        return bits.all();
+    }
+    const unsigned char *data = detail::bytes(bits);
+    std::vector<unsigned char> ones(chunks);
+    detail::for_each_chunk(
+        ex, data, kLeadingBytes, chunks,
+        [&](std::size_t i, std::size_t first, std::size_t last) {
+            ones[i] = nonstd::detail::dispatch::all_ones(data + first,
+                                                         last - first);
+        });
+    const auto &words = nonstd::detail::bitset_access::words(bits);
+    return std::find(ones.begin(), ones.end(), 0) == ones.end() &&
+           nonstd::detail::popcount(words.back()) ==
+               N - (words.size() - 1) * kWordBits;
+}
+
+// The index of the lowest set bit, or size() if there is none
+template <class Executor, std::size_t N, typename Underlying>
+std::size_t find_first(Executor &&ex, const bitset<N, Underlying> &bits) {
+    constexpr std::size_t kBytes = detail::num_bytes<N, Underlying>();
+    const std::size_t chunks = detail::num_chunks(ex, kBytes);
+    if (chunks == 1 ||
+        !nonstd::detail::simd::k_bytes_in_bit_order<Underlying>) {
+        return bits.find_first();
+    }
+    const unsigned char *data = detail::bytes(bits);
+    std::vector<std::size_t> found(chunks);
+    detail::for_each_chunk(
+        ex, data, kBytes, chunks,
+        [&](std::size_t i, std::size_t first, std::size_t last) {
+            const std::size_t pos = nonstd::detail::dispatch::find_first(
+                data + first, last - first);
+            found[i] = pos < 8 * (last - first) ? 8 * first + pos : N;
+        });
+    return std::min(*std::min_element(found.begin(), found.end()), N);
+}
+
+template <class Executor, std::size_t N, typename Underlying>
+bool equal(Executor &&ex, const bitset<N, Underlying> &lhs,
+           const bitset<N, Underlying> &rhs) {
+    constexpr std::size_t kBytes = detail::num_bytes<N, Underlying>();
+    const std::size_t chunks = detail::num_chunks(ex, kBytes);
+    if (chunks == 1) {
+        return lhs == rhs;
+    }
+    const unsigned char *l = detail::bytes(lhs);
+    const unsigned char *r = detail::bytes(rhs);
+    std::vector<unsigned char> same(chunks);
+    detail::for_each_chunk(
+        ex, l, kBytes, chunks,
+        [&](std::size_t i, std::size_t first, std::size_t last) {
+            same[i] = nonstd::detail::dispatch::equal(l + first, r + first,
+                                                      last - first);
+        });
+    return std::find(same.begin(), same.end(), 0) == same.end();
+}
+
+// lhs &= rhs
+template <class Executor, std::size_t N, typename Underlying>
+bitset<N, Underlying> &and_assign(Executor &&ex, bitset<N, Underlying> &lhs,
+                                  const bitset<N, Underlying> &rhs) {
+    if (detail::num_chunks(ex, detail::num_bytes<N, Underlying>()) == 1) {
+        return lhs &= rhs;
+    }
+    return detail::transform(ex, lhs, rhs, nonstd::detail::dispatch::bit_and);
+}
+
+// lhs |= rhs
+template <class Executor, std::size_t N, typename Underlying>
+bitset<N, Underlying> &or_assign(Executor &&ex, bitset<N, Underlying> &lhs,
+                                 const bitset<N, Underlying> &rhs) {
+    if (detail::num_chunks(ex, detail::num_bytes<N, Underlying>()) == 1) {
+        return lhs |= rhs;
+    }
+    return detail::transform(ex, lhs, rhs, nonstd::detail::dispatch::bit_or);
+}
+
+// lhs ^= rhs
+template <class Executor, std::size_t N, typename Underlying>
+bitset<N, Underlying> &xor_assign(Executor &&ex, bitset<N, Underlying> &lhs,
+                                  const bitset<N, Underlying> &rhs) {
+    if (detail::num_chunks(ex, detail::num_bytes<N, Underlying>()) == 1) {
+        return lhs ^= rhs;
+    }
+    return detail::transform(ex, lhs, rhs, nonstd::detail::dispatch::bit_xor);
+}
+
+template <class Executor, std::size_t N, typename Underlying>
+bitset<N, Underlying> &flip(Executor &&ex, bitset<N, Underlying> &bits) {
+    constexpr std::size_t kBytes = detail::num_bytes<N, Underlying>();
+    const std::size_t chunks = detail::num_chunks(ex, kBytes);
+    if (chunks == 1) {
+        return bits.flip();
+    }
+    unsigned char *data = detail::bytes(bits);
+    detail::for_each_chunk(
+        ex, data, kBytes, chunks,
+        [&](std::size_t, std::size_t first, std::size_t last) {
+            nonstd::detail::dispatch::invert(data + first, data + first,
+                                             last - first);
+        });
+    // Clear the bits past N again
+    auto &words = nonstd::detail::bitset_access::words(bits);
+    constexpr std::size_t kTailBits = N % (8 * sizeof(Underlying));
+    if constexpr (kTailBits != 0) {
+        words.back() &= static_cast<Underlying>(
+            (Underlying{1} << kTailBits) - Underlying{1});
+    }
+    return bits;
+}
+
+// bits <<= shift and bits >>= shift. Every chunk reads bytes of its
+// neighbours, so the bits are first copied, in parallel, to a scratch buffer
+// that the chunks then shift out of.
+template <class Executor, std::size_t N, typename Underlying>
+bitset<N, Underlying> &shift_left(Executor &&ex, bitset<N, Underlying> &bits,
+                                  std::size_t shift) {
+    constexpr std::size_t kBytes = detail::num_bytes<N, Underlying>();
+    const std::size_t chunks = detail::num_chunks(ex, kBytes);
+    if (chunks == 1 || shift == 0 || shift >= N ||
+        !nonstd::detail::simd::k_little_endian) {
+        return bits <<= shift;
+    }
+    unsigned char *data = detail::bytes(bits);
+    std::unique_ptr<unsigned char[]> scratch(new unsigned char[kBytes]);
+    detail::for_each_chunk(
+        ex, data, kBytes, chunks,
+        [&](std::size_t, std::size_t first, std::size_t last) {
+            std::memcpy(scratch.get() + first, data + first, last - first);
+        });
+    detail::for_each_chunk(
+        ex, data, kBytes, chunks,
+        [&](std::size_t, std::size_t first, std::size_t last) {
+            detail::shift_left_range(data, scratch.get(), first, last, shift);
+        });
+    auto &words = nonstd::detail::bitset_access::words(bits);
+    constexpr std::size_t kTailBits = N % (8 * sizeof(Underlying));
+    if constexpr (kTailBits != 0) {
+        words.back() &= static_cast<Underlying>(
+            (Underlying{1} << kTailBits) - Underlying{1});
+    }
+    return bits;
+}
+
+template <class Executor, std::size_t N, typename Underlying>
+bitset<N, Underlying> &shift_right(Executor &&ex, bitset<N, Underlying> &bits,
+                                   std::size_t shift) {
+    constexpr std::size_t kBytes = detail::num_bytes<N, Underlying>();
+    const std::size_t chunks = detail::num_chunks(ex, kBytes);
+    if (chunks == 1 || shift == 0 || shift >= N ||
+        !nonstd::detail::simd::k_little_endian) {
+        return bits >>= shift;
+    }
+    unsigned char *data = detail::bytes(bits);
+    std::unique_ptr<unsigned char[]> scratch(new unsigned char[kBytes]);
+    detail::for_each_chunk(
+        ex, data, kBytes, chunks,
+        [&](std::size_t, std::size_t first, std::size_t last) {
+            std::memcpy(scratch.get() + first, data + first, last - first);
+        });
+    detail::for_each_chunk(
+        ex, data, kBytes, chunks,
+        [&](std::size_t, std::size_t first, std::size_t last) {
+            detail::shift_right_range(data, scratch.get(), kBytes, first, last,
+                                      shift);
+        });
+    return bits;
+}
+
+} // namespace parallel
+} // namespace nonstd
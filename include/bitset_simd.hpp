@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace nonstd::detail::simd {
+
+// Below this many bytes the plain word loops are at least as fast
+inline constexpr std::size_t k_min_bytes{32};
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+inline constexpr bool k_little_endian{false};
+#else
+inline constexpr bool k_little_endian{true};
+#endif
+
+// Whether bit i of an array of T is bit i % 8 of byte i / 8, which the
+// shift and search kernels rely on
+template <typename T>
+inline constexpr bool k_bytes_in_bit_order = sizeof(T) == 1 || k_little_endian;
+
+// For every byte value, its bits as eight 0 or 1 bytes, most significant bit
+// first in memory order on little-endian hosts; see format_bits
+struct byte_to_bits_table {
+    std::uint64_t entries[256];
+};
+
+inline constexpr byte_to_bits_table k_byte_to_bits = [] {
+    byte_to_bits_table table{};
+    for (unsigned b = 0; b < 256; b++) {
+        for (unsigned k = 0; k < 8; k++) {
+            table.entries[b] |= std::uint64_t{(b >> (7 - k)) & 1u} << (8 * k);
+        }
+    }
+    return table;
+}();
+
+} // namespace nonstd::detail::simd
+
+// The kernels built for whatever instruction set the compiler targets
+#if defined(__AVX512F__) && defined(__AVX512BW__) && defined(__AVX2__)
+#define NONSTD_SIMD_LEVEL 4
+#elif defined(__AVX2__)
+#define NONSTD_SIMD_LEVEL 3
+#elif defined(__SSE2__) || defined(_M_X64)
+#define NONSTD_SIMD_LEVEL 1
+#else
+#define NONSTD_SIMD_LEVEL 0
+#endif
+#define NONSTD_SIMD_NAMESPACE native
+#include "bitset_simd_kernels.inc"
+#undef NONSTD_SIMD_NAMESPACE
+#undef NONSTD_SIMD_LEVEL
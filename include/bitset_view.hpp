@@ -0,0 +1,289 @@
+#pragma once
+
+#include "bitset.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace nonstd {
+
+// A bitset<N, Underlying> that lives in memory owned by someone else, e.g. a
+// memory-mapped file. The memory holds num_words() words laid out exactly as
+// in a bitset, so the view runs the same kernels without copying. With a
+// const Underlying the view only reads the bits.
+//
+// Like a bitset, the view expects the bits above N to be zero and keeps them
+// that way. Copying a view copies the pointer, not the bits; use assign() or
+// to_bitset() for that.
+template <std::size_t N, typename Underlying = std::uint8_t>
+class bitset_view {
+    using underlying_type_t = std::remove_const_t<Underlying>;
+    static_assert(std::is_unsigned_v<underlying_type_t>,
+                  "bitset_view requires an unsigned underlying type");
+
+    static constexpr bool s_is_const = std::is_const_v<Underlying>;
+
+    static constexpr std::size_t s_num_underlying_bits =
+        8 * sizeof(underlying_type_t);
+    static constexpr std::size_t s_num_words =
+        (N + s_num_underlying_bits - 1) / s_num_underlying_bits;
+    static constexpr std::size_t s_num_bytes =
+        s_num_words * sizeof(underlying_type_t);
+
+    static constexpr underlying_type_t s_last_word_mask =
+        (N % s_num_underlying_bits == 0)
+            ? ~underlying_type_t{0}
+            : underlying_type_t(~underlying_type_t{0}) >>
+                  (s_num_underlying_bits - (N % s_num_underlying_bits));
+
+    static constexpr std::size_t underlying_index(std::size_t i) noexcept {
+        return i / s_num_underlying_bits;
+    }
+
+    static constexpr underlying_type_t mask(std::size_t pos) noexcept {
+        return underlying_type_t{1} << (pos % s_num_underlying_bits);
+    }
+
+    static constexpr bool use_simd() noexcept {
+        return s_num_bytes >= detail::simd::k_min_bytes &&
+               !detail::is_constant_evaluated();
+    }
+
+    static constexpr std::size_t found_or_size(std::size_t pos) noexcept {
+        return pos < N ? pos : N;
+    }
+
+    Underlying *m_data;
+
+    // The words, for the functions that modify them
+    underlying_type_t *words() const noexcept {
+        static_assert(!s_is_const, "cannot modify the bits of a const view");
+        return m_data;
+    }
+
+    unsigned char *bytes() const noexcept {
+        return reinterpret_cast<unsigned char *>(words());
+    }
+
+    const unsigned char *cbytes() const noexcept {
+        return reinterpret_cast<const unsigned char *>(m_data);
+    }
+
+    void check_pos(std::size_t pos, const char *what) const {
+        if (pos >= N) {
+            throw std::out_of_range(std::string("bitset_view::") + what +
+                                    ": pos out of range");
+        }
+    }
+
+  public:
+    using const_view = bitset_view<N, const underlying_type_t>;
+    using bitset_type = bitset<N, underlying_type_t>;
+
+    // The number of words the memory must hold
+    static constexpr std::size_t num_words() noexcept { return s_num_words; }
+
+    // data must point to num_words() words
+    constexpr explicit bitset_view(Underlying *data) noexcept
+        : m_data(data) {}
+
+    template <bool IsConst = s_is_const, std::enable_if_t<!IsConst, int> = 0>
+    constexpr bitset_view(bitset_type &bits) noexcept
+        : m_data(detail::bitset_access::words(bits).data()) {}
+
+    template <bool IsConst = s_is_const, std::enable_if_t<IsConst, int> = 0>
+    constexpr bitset_view(const bitset_type &bits) noexcept
+        : m_data(detail::bitset_access::words(bits).data()) {}
+
+    // A view that may modify its bits converts to one that may not
+    template <bool IsConst = s_is_const, std::enable_if_t<IsConst, int> = 0>
+    constexpr bitset_view(
+        const bitset_view<N, underlying_type_t> &other) noexcept
+        : m_data(other.data()) {}
+
+    constexpr Underlying *data() const noexcept { return m_data; }
+
+    constexpr std::size_t size() const noexcept { return N; }
+
+    constexpr bool operator[](std::size_t i) const noexcept {
+        return (m_data[underlying_index(i)] & mask(i)) != underlying_type_t(0);
+    }
+
+    bool test(std::size_t pos) const {
+        check_pos(pos, "test");
+        return operator[](pos);
+    }
+
+    constexpr std::size_t count() const noexcept {
+        return detail::count_words(m_data, s_num_words);
+    }
+
+    constexpr bool all() const noexcept {
+        if (use_simd()) {
+            return detail::dispatch::all_ones(
+                       cbytes(), s_num_bytes - sizeof(underlying_type_t)) &&
+                   m_data[s_num_words - 1] == s_last_word_mask;
+        }
+        for (std::size_t i = 0; i + 1 < s_num_words; ++i) {
+            if (m_data[i] != underlying_type_t(~underlying_type_t{0})) {
+                return false;
+            }
+        }
+        return m_data[s_num_words - 1] == s_last_word_mask;
+    }
+
+    constexpr bool any() const noexcept {
+        if (use_simd()) {
+            return detail::dispatch::any(cbytes(), s_num_bytes);
+        }
+        for (std::size_t i = 0; i < s_num_words; ++i) {
+            if (m_data[i] != underlying_type_t{0}) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    constexpr bool none() const noexcept { return !any(); }
+
+    // The find functions return size() if no matching bit is found
+    constexpr std::size_t find_first() const noexcept {
+        return found_or_size(detail::find_next_set(m_data, s_num_words, 0));
+    }
+
+    constexpr std::size_t find_next(std::size_t pos) const noexcept {
+        if (pos >= N) {
+            return N;
+        }
+        return found_or_size(
+            detail::find_next_set(m_data, s_num_words, pos + 1));
+    }
+
+    constexpr std::size_t find_last() const noexcept {
+        return found_or_size(detail::find_prev_set(m_data, s_num_words, N));
+    }
+
+    constexpr std::size_t find_prev(std::size_t pos) const noexcept {
+        return found_or_size(detail::find_prev_set(m_data, s_num_words, pos));
+    }
+
+    constexpr std::size_t intersection_count(const_view other) const noexcept {
+        return detail::count_words<detail::and_op>(m_data, other.data(),
+                                                   s_num_words);
+    }
+
+    constexpr std::size_t hamming_distance(const_view other) const noexcept {
+        return detail::count_words<detail::xor_op>(m_data, other.data(),
+                                                   s_num_words);
+    }
+
+    constexpr bool intersects(const_view other) const noexcept {
+        return detail::any_words<detail::and_op>(m_data, other.data(),
+                                                 s_num_words);
+    }
+
+    // Whether every bit set in *this is also set in other
+    constexpr bool is_subset_of(const_view other) const noexcept {
+        return !detail::any_words<detail::and_not_op>(m_data, other.data(),
+                                                      s_num_words);
+    }
+
+    constexpr bool operator==(const_view other) const noexcept {
+        if (use_simd()) {
+            return detail::dispatch::equal(cbytes(), other.cbytes(),
+                                           s_num_bytes);
+        }
+        for (std::size_t i = 0; i < s_num_words; ++i) {
+            if (m_data[i] != other.data()[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    constexpr bool operator!=(const_view other) const noexcept {
+        return !(*this == other);
+    }
+
+    // A copy of the bits
+    bitset_type to_bitset() const noexcept {
+        bitset_type bits;
+        std::memcpy(detail::bitset_access::words(bits).data(), m_data,
+                    s_num_bytes);
+        return bits;
+    }
+
+    // Everything below modifies the bits, and is only available if
+    // Underlying is not const
+
+    bitset_view &set() noexcept {
+        std::memset(bytes(), 0xff, s_num_bytes);
+        words()[s_num_words - 1] = s_last_word_mask;
+        return *this;
+    }
+
+    bitset_view &set(std::size_t pos, bool value = true) {
+        check_pos(pos, "set");
+        if (value) {
+            words()[underlying_index(pos)] |= mask(pos);
+        } else {
+            words()[underlying_index(pos)] &=
+                static_cast<underlying_type_t>(~mask(pos));
+        }
+        return *this;
+    }
+
+    bitset_view &reset() noexcept {
+        std::memset(bytes(), 0, s_num_bytes);
+        return *this;
+    }
+
+    bitset_view &reset(std::size_t pos) { return set(pos, false); }
+
+    bitset_view &flip() noexcept {
+        detail::dispatch::invert(bytes(), cbytes(), s_num_bytes);
+        words()[s_num_words - 1] &= s_last_word_mask;
+        return *this;
+    }
+
+    bitset_view &flip(std::size_t pos) {
+        check_pos(pos, "flip");
+        words()[underlying_index(pos)] ^= mask(pos);
+        return *this;
+    }
+
+    // Copies the bits of other into the memory of this view
+    bitset_view &assign(const_view other) noexcept {
+        std::memmove(bytes(), other.cbytes(), s_num_bytes);
+        return *this;
+    }
+
+    bitset_view &operator&=(const_view other) noexcept {
+        detail::dispatch::bit_and(bytes(), cbytes(), other.cbytes(),
+                                  s_num_bytes);
+        return *this;
+    }
+
+    bitset_view &operator|=(const_view other) noexcept {
+        detail::dispatch::bit_or(bytes(), cbytes(), other.cbytes(),
+                                 s_num_bytes);
+        return *this;
+    }
+
+    bitset_view &operator^=(const_view other) noexcept {
+        detail::dispatch::bit_xor(bytes(), cbytes(), other.cbytes(),
+                                  s_num_bytes);
+        return *this;
+    }
+
+    template <std::size_t, typename> friend class bitset_view;
+};
+
+template <std::size_t N, typename Underlying = std::uint8_t>
+using const_bitset_view = bitset_view<N, const Underlying>;
+
+} // namespace nonstd
@@ -0,0 +1,853 @@
+#pragma once
+
+#include "bitset.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iosfwd>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace nonstd {
+
+namespace detail {
+
+// The number of words that fit in the space of a heap pointer
+template <typename T>
+inline constexpr std::size_t k_words_per_pointer =
+    sizeof(T *) > sizeof(T) ? sizeof(T *) / sizeof(T) : 1;
+
+} // namespace detail
+
+// A bitset whose size is set at runtime. Up to InlineWords words are stored
+// inside the object itself, and only larger bitsets allocate. By default the
+// inline buffer shares its space with the heap pointer, so it costs nothing
+// over a plain heap-backed bitset.
+//
+// The interface follows bitset. Binary operations require both operands to
+// have the same size and throw std::invalid_argument otherwise.
+template <typename Underlying = std::uint8_t,
+          std::size_t InlineWords = detail::k_words_per_pointer<Underlying>>
+class dynamic_bitset {
+    static_assert(std::is_unsigned_v<Underlying>,
+                  "dynamic_bitset requires an unsigned underlying type");
+    static_assert(InlineWords > 0, "dynamic_bitset needs an inline word");
+
+    using underlying_type_t = Underlying;
+
+    static constexpr std::size_t s_num_underlying_bits =
+        8 * sizeof(underlying_type_t);
+
+    static constexpr std::size_t underlying_index(std::size_t i) noexcept {
+        return i / s_num_underlying_bits;
+    }
+
+    static constexpr std::size_t words_for(std::size_t num_bits) noexcept {
+        return (num_bits + s_num_underlying_bits - 1) / s_num_underlying_bits;
+    }
+
+    static constexpr underlying_type_t mask(std::size_t pos) noexcept {
+        return underlying_type_t{1} << (pos % s_num_underlying_bits);
+    }
+
+    static constexpr bool s_bytes_in_bit_order =
+        detail::simd::k_bytes_in_bit_order<underlying_type_t>;
+
+    // Bits of the words above m_size are always zero. m_capacity is in words
+    // and is InlineWords while the inline buffer is in use.
+    std::size_t m_size{0};
+    std::size_t m_capacity{InlineWords};
+    union {
+        underlying_type_t m_inline[InlineWords]{};
+        underlying_type_t *m_heap;
+    };
+
+    bool is_inline() const noexcept { return m_capacity == InlineWords; }
+
+    underlying_type_t *words() noexcept {
+        return is_inline() ? m_inline : m_heap;
+    }
+
+    const underlying_type_t *words() const noexcept {
+        return is_inline() ? m_inline : m_heap;
+    }
+
+    std::size_t num_words() const noexcept { return words_for(m_size); }
+
+    // The word holding bit pos, which must be below m_size. The inline words
+    // are only in use while m_size fits them; telling GCC so keeps it from
+    // warning about writes past them for a size it cannot see.
+    underlying_type_t &word_of(std::size_t pos) noexcept {
+        const std::size_t i = underlying_index(pos);
+#if defined(__GNUC__)
+        if (is_inline() && i >= InlineWords) {
+            __builtin_unreachable();
+        }
+#endif
+        return words()[i];
+    }
+
+    std::size_t num_bytes() const noexcept {
+        return num_words() * sizeof(underlying_type_t);
+    }
+
+    unsigned char *bytes() noexcept {
+        return reinterpret_cast<unsigned char *>(words());
+    }
+
+    const unsigned char *bytes() const noexcept {
+        return reinterpret_cast<const unsigned char *>(words());
+    }
+
+    underlying_type_t last_word_mask() const noexcept {
+        const auto used = m_size % s_num_underlying_bits;
+        return used == 0 ? underlying_type_t(~underlying_type_t{0})
+                         : underlying_type_t(~underlying_type_t{0}) >>
+                               (s_num_underlying_bits - used);
+    }
+
+    void clear_unused_bits() noexcept {
+        if (m_size % s_num_underlying_bits != 0) {
+            words()[num_words() - 1] &= last_word_mask();
+        }
+    }
+
+    std::size_t found_or_size(std::size_t pos) const noexcept {
+        return pos < m_size ? pos : m_size;
+    }
+
+    void check_same_size(const dynamic_bitset &other) const {
+        if (m_size != other.m_size) {
+            throw std::invalid_argument("dynamic_bitset: size mismatch (" +
+                                        std::to_string(m_size) + " vs " +
+                                        std::to_string(other.m_size) + ")");
+        }
+    }
+
+    // Grows the storage to at least num_words words, keeping the words in use.
+    // Words past the ones in use are left uninitialized.
+    void reserve_words(std::size_t num_words) {
+        if (num_words <= m_capacity) {
+            return;
+        }
+        const auto capacity = std::max(num_words, 2 * m_capacity);
+        auto *heap = new underlying_type_t[capacity];
+        std::copy_n(words(), this->num_words(), heap);
+        release();
+        m_heap = heap;
+        m_capacity = capacity;
+    }
+
+    void release() noexcept {
+        if (!is_inline()) {
+            delete[] m_heap;
+        }
+    }
+
+    // Makes the zeroed inline words the active member of the union, leaving
+    // any heap buffer to its new owner
+    void make_inline() noexcept {
+        std::fill_n(m_inline, InlineWords, underlying_type_t{0});
+        m_capacity = InlineWords;
+    }
+
+    // Sets bits [first, m_size), which must all be zero
+    void set_from(std::size_t first) noexcept {
+        auto *data = words();
+        std::size_t i = underlying_index(first);
+        if (first % s_num_underlying_bits != 0) {
+            data[i++] |= static_cast<underlying_type_t>(
+                underlying_type_t(~underlying_type_t{0})
+                << (first % s_num_underlying_bits));
+        }
+        std::fill(data + i, data + num_words(), ~underlying_type_t{0});
+        clear_unused_bits();
+    }
+
+    template <class CharT, class Traits>
+    void assign_chars(const CharT *first, const CharT *last, CharT zero,
+                      CharT one) {
+        // Validated before anything is allocated, as a throwing constructor
+        // would not free it
+        for (auto iter = first; iter != last; ++iter) {
+            if (!Traits::eq(*iter, zero) && !Traits::eq(*iter, one)) {
+                throw std::invalid_argument(
+                    std::string("Unexpected character ") + *iter +
+                    " is neither zero (" + zero + ") or one (" + one + ")");
+            }
+        }
+        resize(static_cast<std::size_t>(last - first));
+        std::size_t i{0};
+        for (auto iter = std::reverse_iterator(last);
+             iter != std::reverse_iterator(first); ++iter, ++i) {
+            if (Traits::eq(*iter, one)) {
+                words()[underlying_index(i)] |= mask(i);
+            }
+        }
+    }
+
+    // Word loops for targets where the bytes of a word are not in bit order
+    void shift_words_left(std::size_t shift) noexcept {
+        auto *data = words();
+        const auto n = num_words();
+        const auto q = shift / s_num_underlying_bits;
+        const auto r = shift % s_num_underlying_bits;
+        for (std::size_t i = n; i-- > q;) {
+            auto value = static_cast<underlying_type_t>(data[i - q] << r);
+            if (r != 0 && i > q) {
+                value |= data[i - q - 1] >> (s_num_underlying_bits - r);
+            }
+            data[i] = value;
+        }
+        std::fill(data, data + q, underlying_type_t{0});
+    }
+
+    void shift_words_right(std::size_t shift) noexcept {
+        auto *data = words();
+        const auto n = num_words();
+        const auto q = shift / s_num_underlying_bits;
+        const auto r = shift % s_num_underlying_bits;
+        for (std::size_t i = 0; i + q < n; i++) {
+            auto value = static_cast<underlying_type_t>(data[i + q] >> r);
+            if (r != 0 && i + q + 1 < n) {
+                value |= static_cast<underlying_type_t>(
+                    data[i + q + 1] << (s_num_underlying_bits - r));
+            }
+            data[i] = value;
+        }
+        std::fill(data + n - q, data + n, underlying_type_t{0});
+    }
+
+    template <class Op>
+    std::size_t count_words_with(const dynamic_bitset &other) const {
+        check_same_size(other);
+        return detail::count_words<Op>(words(), other.words(), num_words());
+    }
+
+  public:
+    dynamic_bitset() noexcept {}
+
+    explicit dynamic_bitset(std::size_t num_bits,
+                            unsigned long long value = 0) {
+        resize(num_bits);
+        constexpr std::size_t num_bits_in_ull{8 * sizeof value};
+        for (std::size_t i = 0; i < num_words() &&
+                                i * s_num_underlying_bits < num_bits_in_ull;
+             i++) {
+            words()[i] = static_cast<underlying_type_t>(
+                value >> (i * s_num_underlying_bits));
+        }
+        clear_unused_bits();
+    }
+
+    // The size is the number of characters read
+    template <class CharT, class Traits, class Alloc>
+    explicit dynamic_bitset(
+        const std::basic_string<CharT, Traits, Alloc> &str,
+        typename std::basic_string<CharT, Traits, Alloc>::size_type pos = 0,
+        typename std::basic_string<CharT, Traits, Alloc>::size_type n =
+            std::basic_string<CharT, Traits, Alloc>::npos,
+        CharT zero = CharT('0'), CharT one = CharT('1')) {
+        if (pos > str.size()) {
+            throw std::out_of_range("pos > str.size()");
+        }
+        const auto len = std::min(n, str.size() - pos);
+        assign_chars<CharT, Traits>(str.data() + pos, str.data() + pos + len,
+                                    zero, one);
+    }
+
+    template <class CharT>
+    explicit dynamic_bitset(const CharT *str, std::size_t n = std::size_t(-1),
+                            CharT zero = CharT('0'), CharT one = CharT('1')) {
+        const auto len = std::char_traits<CharT>::length(str);
+        assign_chars<CharT, std::char_traits<CharT>>(
+            str, str + std::min(n, len), zero, one);
+    }
+
+    dynamic_bitset(const dynamic_bitset &other) {
+        reserve_words(other.num_words());
+        std::copy_n(other.words(), other.num_words(), words());
+        m_size = other.m_size;
+    }
+
+    // Steals the heap buffer of other, leaving it empty
+    dynamic_bitset(dynamic_bitset &&other) noexcept
+        : m_size(other.m_size), m_capacity(other.m_capacity) {
+        if (other.is_inline()) {
+            std::copy_n(other.m_inline, other.num_words(), m_inline);
+        } else {
+            m_heap = other.m_heap;
+            other.make_inline();
+        }
+        other.m_size = 0;
+    }
+
+    dynamic_bitset &operator=(const dynamic_bitset &other) {
+        if (this != &other) {
+            reserve_words(other.num_words());
+            std::copy_n(other.words(), other.num_words(), words());
+            m_size = other.m_size;
+        }
+        return *this;
+    }
+
+    dynamic_bitset &operator=(dynamic_bitset &&other) noexcept {
+        if (this != &other) {
+            release();
+            m_size = other.m_size;
+            if (other.is_inline()) {
+                make_inline();
+                std::copy_n(other.m_inline, other.num_words(), m_inline);
+            } else {
+                m_heap = other.m_heap;
+                m_capacity = other.m_capacity;
+                other.make_inline();
+            }
+            other.m_size = 0;
+        }
+        return *this;
+    }
+
+    ~dynamic_bitset() { release(); }
+
+    void swap(dynamic_bitset &other) noexcept {
+        dynamic_bitset tmp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(tmp);
+    }
+
+    friend void swap(dynamic_bitset &lhs, dynamic_bitset &rhs) noexcept {
+        lhs.swap(rhs);
+    }
+
+    class reference {
+      public:
+        reference(const reference &) = default;
+
+        reference &operator=(bool value) noexcept {
+            if (value) {
+                m_word |= mask(m_pos);
+            } else {
+                m_word &= ~mask(m_pos);
+            }
+            return *this;
+        }
+
+        reference &operator=(const reference &value) noexcept {
+            this->operator=(bool(value));
+            return *this;
+        }
+
+        operator bool() const noexcept {
+            return (m_word & mask(m_pos)) != underlying_type_t{0};
+        }
+        bool operator~() const noexcept { return !bool(*this); }
+
+        reference &flip() noexcept {
+            m_word ^= mask(m_pos);
+            return *this;
+        }
+
+      private:
+        friend dynamic_bitset;
+        reference(underlying_type_t &word, std::size_t pos) noexcept
+            : m_word(word), m_pos(pos) {}
+
+        underlying_type_t &m_word;
+        std::size_t m_pos;
+    };
+
+    // Forward iterator over the positions of the set bits, in increasing
+    // order. It is invalidated by anything that changes the size.
+    class set_bit_iterator {
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = std::size_t;
+
+        set_bit_iterator() noexcept = default;
+
+        reference operator*() const noexcept {
+            return m_index * s_num_underlying_bits +
+                   detail::countr_zero(m_word);
+        }
+
+        set_bit_iterator &operator++() noexcept {
+            m_word = static_cast<underlying_type_t>(m_word & (m_word - 1));
+            skip_zero_words();
+            return *this;
+        }
+
+        set_bit_iterator operator++(int) noexcept {
+            set_bit_iterator copy(*this);
+            ++*this;
+            return copy;
+        }
+
+        friend bool operator==(const set_bit_iterator &lhs,
+                               const set_bit_iterator &rhs) noexcept {
+            return lhs.m_index == rhs.m_index && lhs.m_word == rhs.m_word;
+        }
+
+        friend bool operator!=(const set_bit_iterator &lhs,
+                               const set_bit_iterator &rhs) noexcept {
+            return !(lhs == rhs);
+        }
+
+      private:
+        friend dynamic_bitset;
+        set_bit_iterator(const underlying_type_t *data, std::size_t num_words,
+                         std::size_t index) noexcept
+            : m_data(data), m_num_words(num_words), m_index(index),
+              m_word(index < num_words ? data[index] : underlying_type_t{0}) {
+            skip_zero_words();
+        }
+
+        void skip_zero_words() noexcept {
+            while (m_word == underlying_type_t{0} && m_index < m_num_words) {
+                if (++m_index < m_num_words) {
+                    m_word = m_data[m_index];
+                }
+            }
+        }
+
+        const underlying_type_t *m_data{nullptr};
+        std::size_t m_num_words{0};
+        std::size_t m_index{0};
+        underlying_type_t m_word{0};
+    };
+
+    class set_bit_range {
+      public:
+        using iterator = set_bit_iterator;
+        using const_iterator = set_bit_iterator;
+
+        iterator begin() const noexcept {
+            return set_bit_iterator(m_parent.words(), m_parent.num_words(),
+                                    0);
+        }
+        iterator end() const noexcept {
+            return set_bit_iterator(m_parent.words(), m_parent.num_words(),
+                                    m_parent.num_words());
+        }
+
+      private:
+        friend dynamic_bitset;
+        explicit set_bit_range(const dynamic_bitset &parent) noexcept
+            : m_parent(parent) {}
+
+        const dynamic_bitset &m_parent;
+    };
+
+    set_bit_range set_bits() const noexcept { return set_bit_range(*this); }
+
+    bool operator[](std::size_t i) const {
+        return (words()[underlying_index(i)] & mask(i)) != underlying_type_t(0);
+    }
+
+    reference operator[](std::size_t i) {
+        return reference(word_of(i), i);
+    }
+
+    std::size_t size() const noexcept { return m_size; }
+
+    bool empty() const noexcept { return m_size == 0; }
+
+    // The number of bits that fit without reallocating
+    std::size_t capacity() const noexcept {
+        return m_capacity * s_num_underlying_bits;
+    }
+
+    void reserve(std::size_t num_bits) { reserve_words(words_for(num_bits)); }
+
+    // New bits are set to value
+    void resize(std::size_t num_bits, bool value = false) {
+        const auto old_size = m_size;
+        const auto old_words = num_words();
+        reserve_words(words_for(num_bits));
+        if (num_bits <= old_size) {
+            m_size = num_bits;
+            clear_unused_bits();
+            return;
+        }
+        std::fill(words() + old_words, words() + words_for(num_bits),
+                  underlying_type_t{0});
+        m_size = num_bits;
+        if (value) {
+            set_from(old_size);
+        }
+    }
+
+    void clear() noexcept { m_size = 0; }
+
+    void push_back(bool value) {
+        if (m_size % s_num_underlying_bits == 0) {
+            reserve_words(num_words() + 1);
+            words()[num_words()] = underlying_type_t{0};
+        }
+        ++m_size;
+        if (value) {
+            words()[underlying_index(m_size - 1)] |= mask(m_size - 1);
+        }
+    }
+
+    void pop_back() {
+        if (m_size == 0) {
+            throw std::out_of_range("dynamic_bitset::pop_back: empty");
+        }
+        --m_size;
+        clear_unused_bits();
+    }
+
+    // Appends the bits of other above the current most significant bit
+    dynamic_bitset &append(const dynamic_bitset &other) {
+        if (other.m_size == 0) {
+            return *this;
+        }
+        const auto old_size = m_size;
+        const dynamic_bitset *src = &other;
+        dynamic_bitset copy;
+        if (&other == this) {
+            copy = other;
+            src = &copy;
+        }
+        resize(old_size + src->m_size);
+
+        auto *data = words();
+        const auto q = underlying_index(old_size);
+        const auto r = old_size % s_num_underlying_bits;
+        for (std::size_t i = 0; i < src->num_words(); i++) {
+            const auto word = src->words()[i];
+            data[q + i] |= static_cast<underlying_type_t>(word << r);
+            if (r != 0 && q + i + 1 < num_words()) {
+                data[q + i + 1] |= static_cast<underlying_type_t>(
+                    word >> (s_num_underlying_bits - r));
+            }
+        }
+        return *this;
+    }
+
+    // Appends all bits of a word
+    dynamic_bitset &append(underlying_type_t word) {
+        return append(dynamic_bitset(s_num_underlying_bits, word));
+    }
+
+    dynamic_bitset &set() noexcept {
+        if (m_size > 0) {
+            set_from(0);
+        }
+        return *this;
+    }
+
+    dynamic_bitset &set(std::size_t pos, bool value = true) {
+        if (pos >= m_size) {
+            throw std::out_of_range("dynamic_bitset::set: pos out of range.");
+        }
+        (*this)[pos] = value;
+        return *this;
+    }
+
+    dynamic_bitset &reset() noexcept {
+        std::fill_n(words(), num_words(), underlying_type_t{0});
+        return *this;
+    }
+
+    dynamic_bitset &reset(std::size_t pos) { return set(pos, false); }
+
+    dynamic_bitset &flip() noexcept {
+        detail::dispatch::invert(bytes(), bytes(), num_bytes());
+        clear_unused_bits();
+        return *this;
+    }
+
+    dynamic_bitset &flip(std::size_t pos) {
+        if (pos >= m_size) {
+            throw std::out_of_range("dynamic_bitset::flip: pos out of range");
+        }
+        word_of(pos) ^= mask(pos);
+        return *this;
+    }
+
+    bool test(std::size_t pos) const {
+        if (pos >= m_size) {
+            throw std::out_of_range("dynamic_bitset::test: pos out of range");
+        }
+        return (*this)[pos];
+    }
+
+    std::size_t count() const noexcept {
+        return detail::count_words(words(), num_words());
+    }
+
+    std::size_t intersection_count(const dynamic_bitset &other) const {
+        return count_words_with<detail::and_op>(other);
+    }
+
+    std::size_t union_count(const dynamic_bitset &other) const {
+        return count_words_with<detail::or_op>(other);
+    }
+
+    std::size_t difference_count(const dynamic_bitset &other) const {
+        return count_words_with<detail::and_not_op>(other);
+    }
+
+    std::size_t hamming_distance(const dynamic_bitset &other) const {
+        return count_words_with<detail::xor_op>(other);
+    }
+
+    bool intersects(const dynamic_bitset &other) const {
+        check_same_size(other);
+        return detail::any_words<detail::and_op>(words(), other.words(),
+                                                 num_words());
+    }
+
+    bool is_disjoint(const dynamic_bitset &other) const {
+        return !intersects(other);
+    }
+
+    bool is_subset_of(const dynamic_bitset &other) const {
+        check_same_size(other);
+        return !detail::any_words<detail::and_not_op>(words(), other.words(),
+                                                      num_words());
+    }
+
+    // The find functions return size() if no matching bit is found
+    std::size_t find_first() const noexcept {
+        return found_or_size(detail::find_next_set(words(), num_words(), 0));
+    }
+
+    std::size_t find_next(std::size_t pos) const noexcept {
+        if (pos >= m_size) {
+            return m_size;
+        }
+        return found_or_size(
+            detail::find_next_set(words(), num_words(), pos + 1));
+    }
+
+    std::size_t find_last() const noexcept {
+        return found_or_size(
+            detail::find_prev_set(words(), num_words(), m_size));
+    }
+
+    std::size_t find_prev(std::size_t pos) const noexcept {
+        return found_or_size(
+            detail::find_prev_set(words(), num_words(), std::min(pos, m_size)));
+    }
+
+    // True for an empty bitset, like std::all_of
+    bool all() const noexcept {
+        if (m_size == 0) {
+            return true;
+        }
+        const auto leading_bytes = num_bytes() - sizeof(underlying_type_t);
+        return detail::dispatch::all_ones(bytes(), leading_bytes) &&
+               words()[num_words() - 1] == last_word_mask();
+    }
+
+    bool any() const noexcept {
+        return detail::dispatch::any(bytes(), num_bytes());
+    }
+
+    bool none() const noexcept { return !any(); }
+
+    dynamic_bitset &operator&=(const dynamic_bitset &other) {
+        check_same_size(other);
+        detail::dispatch::bit_and(bytes(), bytes(), other.bytes(),
+                                  num_bytes());
+        return *this;
+    }
+
+    dynamic_bitset &operator|=(const dynamic_bitset &other) {
+        check_same_size(other);
+        detail::dispatch::bit_or(bytes(), bytes(), other.bytes(), num_bytes());
+        return *this;
+    }
+
+    dynamic_bitset &operator^=(const dynamic_bitset &other) {
+        check_same_size(other);
+        detail::dispatch::bit_xor(bytes(), bytes(), other.bytes(),
+                                  num_bytes());
+        return *this;
+    }
+
+    dynamic_bitset operator~() const {
+        return dynamic_bitset(*this).flip();
+    }
+
+    dynamic_bitset operator<<(std::size_t shift) const {
+        return dynamic_bitset(*this) <<= shift;
+    }
+
+    dynamic_bitset &operator<<=(std::size_t shift) noexcept {
+        if (shift == 0) {
+            return *this;
+        }
+        if (shift >= m_size) {
+            return reset();
+        }
+        if (s_bytes_in_bit_order) {
+            detail::dispatch::shift_left(bytes(), num_bytes(), shift);
+        } else {
+            shift_words_left(shift);
+        }
+        clear_unused_bits();
+        return *this;
+    }
+
+    dynamic_bitset operator>>(std::size_t shift) const {
+        return dynamic_bitset(*this) >>= shift;
+    }
+
+    dynamic_bitset &operator>>=(std::size_t shift) noexcept {
+        if (shift == 0) {
+            return *this;
+        }
+        if (shift >= m_size) {
+            return reset();
+        }
+        if (s_bytes_in_bit_order) {
+            detail::dispatch::shift_right(bytes(), num_bytes(), shift);
+        } else {
+            shift_words_right(shift);
+        }
+        return *this;
+    }
+
+    template <class CharT = char, class Traits = std::char_traits<CharT>,
+              class Allocator = std::allocator<CharT>>
+    std::basic_string<CharT, Traits, Allocator>
+    to_string(CharT zero = CharT('0'), CharT one = CharT('1')) const {
+        std::basic_string<CharT, Traits, Allocator> str(m_size, zero);
+        for (auto pos : set_bits()) {
+            str[m_size - 1 - pos] = one;
+        }
+        return str;
+    }
+
+    unsigned long to_ulong() const {
+        if (find_next_set_from(8 * sizeof(unsigned long)) < m_size) {
+            throw std::overflow_error("dynamic_bitset to_ulong overflow error");
+        }
+        return static_cast<unsigned long>(low_bits());
+    }
+
+    unsigned long long to_ullong() const {
+        if (find_next_set_from(8 * sizeof(unsigned long long)) < m_size) {
+            throw std::overflow_error(
+                "dynamic_bitset to_ullong overflow error");
+        }
+        return low_bits();
+    }
+
+    bool operator==(const dynamic_bitset &rhs) const noexcept {
+        return m_size == rhs.m_size &&
+               detail::dispatch::equal(bytes(), rhs.bytes(), num_bytes());
+    }
+
+    bool operator!=(const dynamic_bitset &rhs) const noexcept {
+        return !(*this == rhs);
+    }
+
+    friend dynamic_bitset operator&(const dynamic_bitset &lhs,
+                                    const dynamic_bitset &rhs) {
+        return dynamic_bitset(lhs) &= rhs;
+    }
+
+    friend dynamic_bitset operator|(const dynamic_bitset &lhs,
+                                    const dynamic_bitset &rhs) {
+        return dynamic_bitset(lhs) |= rhs;
+    }
+
+    friend dynamic_bitset operator^(const dynamic_bitset &lhs,
+                                    const dynamic_bitset &rhs) {
+        return dynamic_bitset(lhs) ^= rhs;
+    }
+
+    template <class CharT, class Traits>
+    friend std::basic_ostream<CharT, Traits> &
+    operator<<(std::basic_ostream<CharT, Traits> &os,
+               const dynamic_bitset &bits) {
+        return os << bits.to_string(
+                   std::use_facet<std::ctype<CharT>>(os.getloc()).widen('0'),
+                   std::use_facet<std::ctype<CharT>>(os.getloc()).widen('1'));
+    }
+
+    // Skips leading whitespace, then reads zeros and ones up to a whitespace
+    // character or the end of the input, sizing the bitset to the number
+    // read. As with bitset, any other character is extracted and sets
+    // failbit, as does reading no character at all.
+    template <class CharT, class Traits>
+    friend std::basic_istream<CharT, Traits> &
+    operator>>(std::basic_istream<CharT, Traits> &is, dynamic_bitset &bits) {
+        std::basic_string<CharT, Traits> str;
+        if (typename std::basic_istream<CharT, Traits>::sentry sentry(is);
+            sentry) {
+            const auto zero = is.widen('0');
+            const auto one = is.widen('1');
+            auto *buf = is.rdbuf();
+            for (auto c = buf->sgetc();; c = buf->snextc()) {
+                if (Traits::eq_int_type(c, Traits::eof())) {
+                    is.setstate(std::ios_base::eofbit);
+                    break;
+                }
+                const auto ch = Traits::to_char_type(c);
+                if (!Traits::eq(ch, zero) && !Traits::eq(ch, one)) {
+                    if (!std::isspace(ch, is.getloc())) {
+                        buf->sbumpc();
+                        is.setstate(std::ios_base::failbit);
+                    }
+                    break;
+                }
+                str.push_back(ch);
+            }
+        }
+        if (str.empty()) {
+            is.setstate(std::ios_base::failbit);
+            return is;
+        }
+        bits = dynamic_bitset(str, 0, str.size(), is.widen('0'),
+                              is.widen('1'));
+        return is;
+    }
+
+    friend struct std::hash<dynamic_bitset>;
+
+  private:
+    std::size_t find_next_set_from(std::size_t pos) const noexcept {
+        return detail::find_next_set(words(), num_words(), pos);
+    }
+
+    unsigned long long low_bits() const noexcept {
+        unsigned long long value{0};
+        for (std::size_t i = 0; i < num_words() &&
+                                i * s_num_underlying_bits < 8 * sizeof value;
+             i++) {
+            value |= static_cast<unsigned long long>(words()[i])
+                     << (i * s_num_underlying_bits);
+        }
+        return value;
+    }
+};
+
+} // namespace nonstd
+
+namespace std {
+
+template <typename Underlying, size_t InlineWords>
+struct hash<nonstd::dynamic_bitset<Underlying, InlineWords>> {
+    size_t operator()(const nonstd::dynamic_bitset<Underlying, InlineWords> &s)
+        const noexcept {
+        // Equal to the hash of a nonstd::bitset with the same bits
+        return nonstd::detail::hash_words(s.words(), s.num_words(), s.size());
+    }
+};
+
+} // namespace std
@@ -0,0 +1,378 @@
+#pragma once
+
+#include "bitset.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace nonstd {
+
+// A bitset for large, sparse sets. Besides the bits themselves it keeps
+// summary levels of 64-bit words: bit i of level 1 is set iff word i of the
+// bits is not zero, and bit i of level l + 1 iff word i of level l is not
+// zero, up to a top level of a single word. Finding a set bit then probes one
+// word per level instead of scanning every word in between, and any()/none()
+// only look at the top word.
+//
+// Underlying is the word type of the bits, so that they are a bitset<N,
+// Underlying>; the summaries are 64-ary whatever it is.
+//
+// Single-bit updates maintain the summaries as they go; whole-bitset updates
+// rebuild them, which costs one pass over the words.
+template <std::size_t N, typename Underlying = std::uint8_t>
+class hierarchical_bitset {
+    static_assert(N > 0, "hierarchical_bitset requires at least one bit");
+    static_assert(std::is_unsigned_v<Underlying>,
+                  "hierarchical_bitset requires an unsigned underlying type");
+
+    using underlying_type_t = Underlying;
+    using summary_type_t = std::uint64_t;
+    using bitset_type = bitset<N, Underlying>;
+
+    static constexpr std::size_t s_num_underlying_bits =
+        8 * sizeof(underlying_type_t);
+    static constexpr std::size_t s_num_summary_bits = 64;
+
+    // The number of words in level l, where level 0 holds the bits
+    static constexpr std::size_t level_words(std::size_t l) noexcept {
+        std::size_t words = (N + s_num_underlying_bits - 1) /
+                            s_num_underlying_bits;
+        for (; l > 0; l--) {
+            words = (words + s_num_summary_bits - 1) / s_num_summary_bits;
+        }
+        return words;
+    }
+
+    static constexpr std::size_t top_level() noexcept {
+        std::size_t l{0};
+        while (level_words(l) > 1) {
+            l++;
+        }
+        return l;
+    }
+
+    static constexpr std::size_t s_top_level = top_level();
+
+    static constexpr std::array<std::size_t, s_top_level + 1> s_level_words =
+        [] {
+            std::array<std::size_t, s_top_level + 1> words{};
+            for (std::size_t l = 0; l <= s_top_level; l++) {
+                words[l] = level_words(l);
+            }
+            return words;
+        }();
+
+    // Where level l starts in m_summary, for l >= 1
+    static constexpr std::array<std::size_t, s_top_level + 1> s_level_offsets =
+        [] {
+            std::array<std::size_t, s_top_level + 1> offsets{};
+            for (std::size_t l = 2; l <= s_top_level; l++) {
+                offsets[l] = offsets[l - 1] + level_words(l - 1);
+            }
+            return offsets;
+        }();
+
+    // At least one word so that the array is never empty
+    static constexpr std::size_t s_num_summary_words =
+        s_top_level == 0
+            ? 1
+            : s_level_offsets[s_top_level] + s_level_words[s_top_level];
+
+    static constexpr underlying_type_t mask(std::size_t pos) noexcept {
+        return underlying_type_t{1} << (pos % s_num_underlying_bits);
+    }
+
+    static constexpr summary_type_t summary_mask(std::size_t i) noexcept {
+        return summary_type_t{1} << (i % s_num_summary_bits);
+    }
+
+    bitset_type m_bits;
+    std::array<summary_type_t, s_num_summary_words> m_summary{};
+
+    constexpr const underlying_type_t *words() const noexcept {
+        return detail::bitset_access::words(m_bits).data();
+    }
+
+    constexpr underlying_type_t *words() noexcept {
+        return detail::bitset_access::words(m_bits).data();
+    }
+
+    // Summary level l, for 1 <= l <= s_top_level
+    constexpr const summary_type_t *level(std::size_t l) const noexcept {
+        return m_summary.data() + s_level_offsets[l];
+    }
+
+    constexpr summary_type_t *level(std::size_t l) noexcept {
+        return m_summary.data() + s_level_offsets[l];
+    }
+
+    constexpr void rebuild_summary() noexcept {
+        m_summary = {};
+        if constexpr (s_top_level > 0) {
+            summary_type_t *first = level(1);
+            for (std::size_t i = 0; i < s_level_words[0]; i++) {
+                if (words()[i] != underlying_type_t{0}) {
+                    first[i / s_num_summary_bits] |= summary_mask(i);
+                }
+            }
+            for (std::size_t l = 2; l <= s_top_level; l++) {
+                const summary_type_t *below = level(l - 1);
+                summary_type_t *above = level(l);
+                for (std::size_t i = 0; i < s_level_words[l - 1]; i++) {
+                    if (below[i] != summary_type_t{0}) {
+                        above[i / s_num_summary_bits] |= summary_mask(i);
+                    }
+                }
+            }
+        }
+    }
+
+    // Word i of level 0 went from zero to non-zero
+    constexpr void mark_nonempty(std::size_t i) noexcept {
+        for (std::size_t l = 1; l <= s_top_level; l++) {
+            summary_type_t &word = level(l)[i / s_num_summary_bits];
+            const bool was_empty = word == summary_type_t{0};
+            word |= summary_mask(i);
+            if (!was_empty) {
+                return;
+            }
+            i /= s_num_summary_bits;
+        }
+    }
+
+    // Word i of level 0 went from non-zero to zero
+    constexpr void mark_empty(std::size_t i) noexcept {
+        for (std::size_t l = 1; l <= s_top_level; l++) {
+            summary_type_t &word = level(l)[i / s_num_summary_bits];
+            word &= ~summary_mask(i);
+            if (word != summary_type_t{0}) {
+                return;
+            }
+            i /= s_num_summary_bits;
+        }
+    }
+
+    // The first set bit at or after pos, or N. Climbs while the rest of the
+    // current word is empty, then descends along the lowest set bits.
+    constexpr std::size_t next_set(std::size_t pos) const noexcept {
+        const std::size_t i = pos / s_num_underlying_bits;
+        if (i >= s_level_words[0]) {
+            return N;
+        }
+        const auto word = static_cast<underlying_type_t>(
+            words()[i] & static_cast<underlying_type_t>(
+                             underlying_type_t(~underlying_type_t{0})
+                             << (pos % s_num_underlying_bits)));
+        if (word != underlying_type_t{0}) {
+            return i * s_num_underlying_bits + detail::countr_zero(word);
+        }
+        pos = i + 1;
+        std::size_t l{1};
+        for (;; l++) {
+            if (l > s_top_level) {
+                return N;
+            }
+            const std::size_t j = pos / s_num_summary_bits;
+            if (j >= s_level_words[l]) {
+                return N;
+            }
+            const summary_type_t summary =
+                level(l)[j] & (~summary_type_t{0} << (pos % s_num_summary_bits));
+            if (summary != summary_type_t{0}) {
+                pos = j * s_num_summary_bits + detail::countr_zero(summary);
+                break;
+            }
+            pos = j + 1;
+        }
+        for (; l > 1; l--) {
+            pos = pos * s_num_summary_bits +
+                  detail::countr_zero(level(l - 1)[pos]);
+        }
+        return pos * s_num_underlying_bits + detail::countr_zero(words()[pos]);
+    }
+
+    // The last set bit before pos, or N
+    constexpr std::size_t prev_set(std::size_t pos) const noexcept {
+        pos = pos < N ? pos : N;
+        if (pos == 0) {
+            return N;
+        }
+        const std::size_t last = pos - 1;
+        const std::size_t i = last / s_num_underlying_bits;
+        const auto word = static_cast<underlying_type_t>(
+            words()[i] & static_cast<underlying_type_t>(
+                             underlying_type_t(~underlying_type_t{0}) >>
+                             (s_num_underlying_bits - 1 -
+                              last % s_num_underlying_bits)));
+        if (word != underlying_type_t{0}) {
+            return i * s_num_underlying_bits + s_num_underlying_bits - 1 -
+                   detail::countl_zero(word);
+        }
+        pos = i;
+        std::size_t l{1};
+        for (;; l++) {
+            if (l > s_top_level || pos == 0) {
+                return N;
+            }
+            const std::size_t j = (pos - 1) / s_num_summary_bits;
+            const summary_type_t summary =
+                level(l)[j] & (~summary_type_t{0} >>
+                               (s_num_summary_bits - 1 -
+                                (pos - 1) % s_num_summary_bits));
+            if (summary != summary_type_t{0}) {
+                pos = j * s_num_summary_bits + s_num_summary_bits - 1 -
+                      detail::countl_zero(summary);
+                break;
+            }
+            pos = j;
+        }
+        for (; l > 1; l--) {
+            pos = pos * s_num_summary_bits + s_num_summary_bits - 1 -
+                  detail::countl_zero(level(l - 1)[pos]);
+        }
+        return pos * s_num_underlying_bits + s_num_underlying_bits - 1 -
+               detail::countl_zero(words()[pos]);
+    }
+
+    static constexpr void check_pos(std::size_t pos, const char *what) {
+        if (pos >= N) {
+            throw std::out_of_range(std::string("hierarchical_bitset::") +
+                                    what + ": pos out of range");
+        }
+    }
+
+  public:
+    constexpr hierarchical_bitset() noexcept = default;
+
+    constexpr explicit hierarchical_bitset(const bitset_type &bits) noexcept
+        : m_bits(bits) {
+        rebuild_summary();
+    }
+
+    constexpr std::size_t size() const noexcept { return N; }
+
+    // The number of summary levels a search climbs at most, i.e. the 64-based
+    // logarithm of the number of words, rounded up
+    static constexpr std::size_t summary_levels() noexcept {
+        return s_top_level;
+    }
+
+    // The bits as a plain bitset
+    constexpr const bitset_type &bits() const noexcept { return m_bits; }
+
+    constexpr bool operator[](std::size_t pos) const noexcept {
+        return (words()[pos / s_num_underlying_bits] & mask(pos)) !=
+               underlying_type_t{0};
+    }
+
+    bool test(std::size_t pos) const {
+        check_pos(pos, "test");
+        return (*this)[pos];
+    }
+
+    constexpr hierarchical_bitset &set(std::size_t pos, bool value = true) {
+        check_pos(pos, "set");
+        const std::size_t i = pos / s_num_underlying_bits;
+        underlying_type_t &word = words()[i];
+        if (value) {
+            const bool was_empty = word == underlying_type_t{0};
+            word |= mask(pos);
+            if (was_empty) {
+                mark_nonempty(i);
+            }
+        } else if ((word & mask(pos)) != underlying_type_t{0}) {
+            word &= static_cast<underlying_type_t>(~mask(pos));
+            if (word == underlying_type_t{0}) {
+                mark_empty(i);
+            }
+        }
+        return *this;
+    }
+
+    constexpr hierarchical_bitset &reset(std::size_t pos) {
+        check_pos(pos, "reset");
+        return set(pos, false);
+    }
+
+    constexpr hierarchical_bitset &flip(std::size_t pos) {
+        check_pos(pos, "flip");
+        return set(pos, !(*this)[pos]);
+    }
+
+    constexpr hierarchical_bitset &set() noexcept {
+        m_bits.set();
+        rebuild_summary();
+        return *this;
+    }
+
+    constexpr hierarchical_bitset &reset() noexcept {
+        m_bits.reset();
+        m_summary = {};
+        return *this;
+    }
+
+    constexpr hierarchical_bitset &flip() noexcept {
+        m_bits.flip();
+        rebuild_summary();
+        return *this;
+    }
+
+    constexpr hierarchical_bitset &operator&=(const bitset_type &rhs) noexcept {
+        m_bits &= rhs;
+        rebuild_summary();
+        return *this;
+    }
+
+    constexpr hierarchical_bitset &operator|=(const bitset_type &rhs) noexcept {
+        m_bits |= rhs;
+        rebuild_summary();
+        return *this;
+    }
+
+    constexpr hierarchical_bitset &operator^=(const bitset_type &rhs) noexcept {
+        m_bits ^= rhs;
+        rebuild_summary();
+        return *this;
+    }
+
+    constexpr bool any() const noexcept {
+        if constexpr (s_top_level == 0) {
+            return words()[0] != underlying_type_t{0};
+        } else {
+            return level(s_top_level)[0] != summary_type_t{0};
+        }
+    }
+
+    constexpr bool none() const noexcept { return !any(); }
+
+    constexpr bool all() const noexcept { return m_bits.all(); }
+
+    constexpr std::size_t count() const noexcept { return m_bits.count(); }
+
+    // The find functions return size() if no matching bit is found
+    constexpr std::size_t find_first() const noexcept { return next_set(0); }
+
+    constexpr std::size_t find_next(std::size_t pos) const noexcept {
+        return pos >= N ? N : next_set(pos + 1);
+    }
+
+    constexpr std::size_t find_last() const noexcept { return prev_set(N); }
+
+    constexpr std::size_t find_prev(std::size_t pos) const noexcept {
+        return prev_set(pos);
+    }
+
+    constexpr bool operator==(const hierarchical_bitset &rhs) const noexcept {
+        return m_bits == rhs.m_bits;
+    }
+
+    constexpr bool operator!=(const hierarchical_bitset &rhs) const noexcept {
+        return !(*this == rhs);
+    }
+};
+
+} // namespace nonstd
@@ -0,0 +1,218 @@
+#pragma once
+
+#include "bitset.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+namespace nonstd {
+
+namespace detail {
+
+// Position of the k-th (from 0) set bit of word, which must have more than k
+// set bits
+inline std::size_t select_in_word(std::uint64_t word, std::size_t k) noexcept {
+#if defined(__BMI2__)
+    return countr_zero(_pdep_u64(std::uint64_t{1} << k, word));
+#else
+    std::size_t pos{0};
+    for (;; pos += 8) {
+        const std::size_t cnt = popcount((word >> pos) & 0xffu);
+        if (k < cnt) {
+            break;
+        }
+        k -= cnt;
+    }
+    word >>= pos;
+    for (; k > 0; k--) {
+        word &= word - 1;
+    }
+    return pos + countr_zero(word);
+#endif
+}
+
+} // namespace detail
+
+// A rank/select directory over a bitset, which must outlive it. rank(i)
+// counts the set bits before i and select(k) finds the k-th set bit.
+//
+// The bits are read as 64-bit words whatever the Underlying type. Every
+// superblock of 4096 bits stores the number of set bits before it, and every
+// block of 512 bits the number since the start of its superblock, which
+// costs under 5% of the bitset's size. rank() adds the two to the popcount of
+// at most 8 words. select() narrows the superblocks down with a sample of
+// every 8192nd set bit, then walks blocks and words the same way.
+//
+// The directory does not see changes to the bits: after modifying bits at
+// or after pos, call rebuild(pos), which only recomputes the directory from
+// the superblock containing pos onwards.
+template <std::size_t N, typename Underlying = std::uint8_t>
+class rank_select {
+    static_assert(N > 0, "rank_select requires at least one bit");
+    static_assert(sizeof(Underlying) <= sizeof(std::uint64_t),
+                  "rank_select reads the bits as 64-bit words");
+
+    using bitset_type = bitset<N, Underlying>;
+
+    static constexpr std::size_t s_word_bits = 64;
+    static constexpr std::size_t s_block_words = 8;
+    static constexpr std::size_t s_superblock_blocks = 8;
+    static constexpr std::size_t s_select_sample = 8192;
+
+    static constexpr std::size_t s_num_words =
+        (N + s_word_bits - 1) / s_word_bits;
+    static constexpr std::size_t s_num_blocks =
+        (s_num_words + s_block_words - 1) / s_block_words;
+    static constexpr std::size_t s_num_superblocks =
+        (s_num_blocks + s_superblock_blocks - 1) / s_superblock_blocks;
+
+    const bitset_type *m_bits;
+    std::vector<std::uint64_t> m_superblocks;
+    std::vector<std::uint16_t> m_blocks;
+    // The superblock holding set bit j * s_select_sample
+    std::vector<std::size_t> m_samples;
+    std::size_t m_count{0};
+
+    // The 64-bit word j of the bits
+    std::uint64_t word(std::size_t j) const noexcept {
+        const auto &words = detail::bitset_access::words(*m_bits);
+        if constexpr (sizeof(Underlying) == sizeof(std::uint64_t)) {
+            return words[j];
+        } else {
+            constexpr std::size_t kPerWord =
+                sizeof(std::uint64_t) / sizeof(Underlying);
+            std::uint64_t value{0};
+            for (std::size_t k = 0; k < kPerWord; k++) {
+                const std::size_t i = j * kPerWord + k;
+                if (i < words.size()) {
+                    value |= static_cast<std::uint64_t>(words[i])
+                             << (8 * sizeof(Underlying) * k);
+                }
+            }
+            return value;
+        }
+    }
+
+    void build_from(std::size_t first_superblock) {
+        const std::uint64_t before = m_superblocks[first_superblock];
+        std::uint64_t running = before;
+        for (std::size_t s = first_superblock; s < s_num_superblocks; s++) {
+            m_superblocks[s] = running;
+            const std::size_t last_block =
+                std::min(s_num_blocks, (s + 1) * s_superblock_blocks);
+            for (std::size_t b = s * s_superblock_blocks; b < last_block; b++) {
+                m_blocks[b] = static_cast<std::uint16_t>(running -
+                                                         m_superblocks[s]);
+                const std::size_t last_word =
+                    std::min(s_num_words, (b + 1) * s_block_words);
+                for (std::size_t j = b * s_block_words; j < last_word; j++) {
+                    running += detail::popcount(word(j));
+                }
+            }
+        }
+        m_count = static_cast<std::size_t>(running);
+
+        // Set bits before the first superblock did not move
+        m_samples.resize((m_count + s_select_sample - 1) / s_select_sample);
+        std::size_t s = first_superblock;
+        for (std::size_t j = (before + s_select_sample - 1) / s_select_sample;
+             j < m_samples.size(); j++) {
+            while (s + 1 < s_num_superblocks &&
+                   m_superblocks[s + 1] <= j * s_select_sample) {
+                s++;
+            }
+            m_samples[j] = s;
+        }
+    }
+
+  public:
+    explicit rank_select(const bitset_type &bits)
+        : m_bits(&bits), m_superblocks(s_num_superblocks),
+          m_blocks(s_num_blocks) {
+        build_from(0);
+    }
+
+    constexpr std::size_t size() const noexcept { return N; }
+
+    // The number of set bits
+    std::size_t count() const noexcept { return m_count; }
+
+    // The number of set bits before pos. Throws std::out_of_range if pos is
+    // greater than size().
+    std::size_t rank(std::size_t pos) const {
+        if (pos >= N) {
+            if (pos == N) {
+                return m_count;
+            }
+            throw std::out_of_range("rank_select::rank: pos out of range");
+        }
+        const std::size_t j = pos / s_word_bits;
+        const std::size_t b = j / s_block_words;
+        std::size_t cnt = static_cast<std::size_t>(
+            m_superblocks[b / s_superblock_blocks] + m_blocks[b]);
+        for (std::size_t i = b * s_block_words; i < j; i++) {
+            cnt += detail::popcount(word(i));
+        }
+        if (pos % s_word_bits != 0) {
+            cnt += detail::popcount(
+                word(j) &
+                ((std::uint64_t{1} << (pos % s_word_bits)) - 1));
+        }
+        return cnt;
+    }
+
+    // The position of the k-th set bit, counting from 0, or size() if there
+    // are no more than k set bits
+    std::size_t select(std::size_t k) const noexcept {
+        if (k >= m_count) {
+            return N;
+        }
+        const std::size_t sample = k / s_select_sample;
+        const auto first = m_superblocks.begin() + m_samples[sample];
+        const auto last = sample + 1 < m_samples.size()
+                              ? m_superblocks.begin() +
+                                    m_samples[sample + 1] + 1
+                              : m_superblocks.end();
+        const std::size_t s = static_cast<std::size_t>(
+            std::upper_bound(first, last, std::uint64_t{k}) -
+            m_superblocks.begin() - 1);
+        k -= static_cast<std::size_t>(m_superblocks[s]);
+
+        std::size_t b = s * s_superblock_blocks;
+        const std::size_t last_block =
+            std::min(s_num_blocks, b + s_superblock_blocks);
+        while (b + 1 < last_block && m_blocks[b + 1] <= k) {
+            b++;
+        }
+        k -= m_blocks[b];
+
+        std::size_t j = b * s_block_words;
+        for (;; j++) {
+            const std::size_t cnt = detail::popcount(word(j));
+            if (k < cnt) {
+                break;
+            }
+            k -= cnt;
+        }
+        return j * s_word_bits + detail::select_in_word(word(j), k);
+    }
+
+    // Recomputes the whole directory
+    void rebuild() { build_from(0); }
+
+    // Recomputes the directory after changes to bits at or after pos only
+    void rebuild(std::size_t pos) {
+        build_from(std::min(pos, N - 1) / s_word_bits / s_block_words /
+                   s_superblock_blocks);
+    }
+};
+
+} // namespace nonstd
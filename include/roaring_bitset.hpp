@@ -0,0 +1,732 @@
+#pragma once
+
+#include "bitset.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace nonstd {
+
+namespace detail {
+namespace roaring {
+
+// Every container holds the values of one chunk of 2^16, keyed by their upper
+// 16 bits
+constexpr std::size_t k_chunk_bits = std::size_t{1} << 16;
+constexpr std::size_t k_max_array_size = 4096;
+
+using bitmap_t = bitset<k_chunk_bits, std::uint64_t>;
+using array_t = std::vector<std::uint16_t>;
+
+// A run of consecutive values, both ends included
+struct run {
+    std::uint16_t first;
+    std::uint16_t last;
+
+    friend bool operator==(const run &lhs, const run &rhs) noexcept {
+        return lhs.first == rhs.first && lhs.last == rhs.last;
+    }
+};
+
+using runs_t = std::vector<run>;
+
+// Bitmaps are kept on the heap so that array and run containers stay small.
+// Copies are deep.
+class bitmap_box {
+    std::unique_ptr<bitmap_t> m_bits;
+
+  public:
+    bitmap_box() : m_bits(std::make_unique<bitmap_t>()) {}
+    bitmap_box(const bitmap_box &other)
+        : m_bits(std::make_unique<bitmap_t>(*other.m_bits)) {}
+    bitmap_box(bitmap_box &&) noexcept = default;
+    bitmap_box &operator=(const bitmap_box &other) {
+        if (m_bits) {
+            *m_bits = *other.m_bits;
+        } else {
+            m_bits = std::make_unique<bitmap_t>(*other.m_bits);
+        }
+        return *this;
+    }
+    bitmap_box &operator=(bitmap_box &&) noexcept = default;
+
+    bitmap_t &operator*() noexcept { return *m_bits; }
+    const bitmap_t &operator*() const noexcept { return *m_bits; }
+    bitmap_t *operator->() noexcept { return m_bits.get(); }
+    const bitmap_t *operator->() const noexcept { return m_bits.get(); }
+
+    friend bool operator==(const bitmap_box &lhs,
+                           const bitmap_box &rhs) noexcept {
+        return *lhs == *rhs;
+    }
+};
+
+// A sorted array while there are at most k_max_array_size values, a bitmap
+// above that, and runs after roaring_bitset::run_optimize() if they are
+// smaller than both.
+struct container {
+    std::uint16_t key{0};
+    std::uint32_t count{0};
+    std::variant<array_t, bitmap_box, runs_t> data;
+};
+
+inline unsigned char *bytes(bitmap_t &bits) noexcept {
+    return reinterpret_cast<unsigned char *>(
+        bitset_access::words(bits).data());
+}
+
+inline const unsigned char *bytes(const bitmap_t &bits) noexcept {
+    return reinterpret_cast<const unsigned char *>(
+        bitset_access::words(bits).data());
+}
+
+// Calls f with every value of the container in increasing order
+template <class F> void for_each_value(const container &c, F &&f) {
+    if (const auto *values = std::get_if<array_t>(&c.data)) {
+        for (auto value : *values) {
+            f(value);
+        }
+    } else if (const auto *bits = std::get_if<bitmap_box>(&c.data)) {
+        for (auto pos : (*bits)->set_bits()) {
+            f(static_cast<std::uint16_t>(pos));
+        }
+    } else {
+        for (const auto &r : std::get<runs_t>(c.data)) {
+            for (std::size_t value = r.first; value <= r.last; value++) {
+                f(static_cast<std::uint16_t>(value));
+            }
+        }
+    }
+}
+
+inline void fill_bitmap(const container &c, bitmap_t &bits) {
+    if (const auto *box = std::get_if<bitmap_box>(&c.data)) {
+        bits = **box;
+        return;
+    }
+    bits.reset();
+    for_each_value(c, [&bits](std::uint16_t value) { bits[value] = true; });
+}
+
+// Calls f with the container's values as a bitmap, converting only if needed
+template <class F> decltype(auto) with_bitmap(const container &c, F &&f) {
+    if (const auto *box = std::get_if<bitmap_box>(&c.data)) {
+        return f(**box);
+    }
+    bitmap_box bits;
+    fill_bitmap(c, *bits);
+    return f(*bits);
+}
+
+inline container from_array(std::uint16_t key, array_t values) {
+    container c;
+    c.key = key;
+    c.count = static_cast<std::uint32_t>(values.size());
+    if (values.size() <= k_max_array_size) {
+        c.data = std::move(values);
+    } else {
+        bitmap_box bits;
+        for (auto value : values) {
+            (*bits)[value] = true;
+        }
+        c.data = std::move(bits);
+    }
+    return c;
+}
+
+inline container from_bitmap(std::uint16_t key, bitmap_box bits) {
+    container c;
+    c.key = key;
+    c.count = static_cast<std::uint32_t>(bits->count());
+    if (c.count <= k_max_array_size) {
+        array_t values;
+        values.reserve(c.count);
+        for (auto pos : bits->set_bits()) {
+            values.push_back(static_cast<std::uint16_t>(pos));
+        }
+        c.data = std::move(values);
+    } else {
+        c.data = std::move(bits);
+    }
+    return c;
+}
+
+inline bool contains(const container &c, std::uint16_t value) {
+    if (const auto *values = std::get_if<array_t>(&c.data)) {
+        return std::binary_search(values->begin(), values->end(), value);
+    }
+    if (const auto *bits = std::get_if<bitmap_box>(&c.data)) {
+        return (**bits)[value];
+    }
+    const auto &runs = std::get<runs_t>(c.data);
+    const auto it = std::lower_bound(
+        runs.begin(), runs.end(), value,
+        [](const run &r, std::uint16_t v) { return r.last < v; });
+    return it != runs.end() && it->first <= value;
+}
+
+// The smallest value >= from, or k_chunk_bits if there is none
+inline std::size_t next_value(const container &c, std::size_t from) {
+    if (from >= k_chunk_bits) {
+        return k_chunk_bits;
+    }
+    if (const auto *values = std::get_if<array_t>(&c.data)) {
+        const auto it = std::lower_bound(values->begin(), values->end(), from);
+        return it == values->end() ? k_chunk_bits : *it;
+    }
+    if (const auto *bits = std::get_if<bitmap_box>(&c.data)) {
+        return (**bits)[from] ? from : (*bits)->find_next(from);
+    }
+    const auto &runs = std::get<runs_t>(c.data);
+    const auto it = std::lower_bound(
+        runs.begin(), runs.end(), from,
+        [](const run &r, std::size_t v) { return r.last < v; });
+    if (it == runs.end()) {
+        return k_chunk_bits;
+    }
+    return std::max<std::size_t>(it->first, from);
+}
+
+inline std::size_t last_value(const container &c) {
+    if (const auto *values = std::get_if<array_t>(&c.data)) {
+        return values->back();
+    }
+    if (const auto *bits = std::get_if<bitmap_box>(&c.data)) {
+        return (*bits)->find_last();
+    }
+    return std::get<runs_t>(c.data).back().last;
+}
+
+// Single-value updates work on arrays and bitmaps; runs are expanded first
+inline void expand_runs(container &c) {
+    if (std::holds_alternative<runs_t>(c.data)) {
+        bitmap_box bits;
+        fill_bitmap(c, *bits);
+        c = from_bitmap(c.key, std::move(bits));
+    }
+}
+
+inline void add(container &c, std::uint16_t value) {
+    expand_runs(c);
+    if (auto *values = std::get_if<array_t>(&c.data)) {
+        const auto it = std::lower_bound(values->begin(), values->end(), value);
+        if (it != values->end() && *it == value) {
+            return;
+        }
+        values->insert(it, value);
+        if (values->size() > k_max_array_size) {
+            c = from_array(c.key, std::move(*values));
+        } else {
+            c.count++;
+        }
+        return;
+    }
+    auto &bits = std::get<bitmap_box>(c.data);
+    if (!(*bits)[value]) {
+        (*bits)[value] = true;
+        c.count++;
+    }
+}
+
+inline void remove(container &c, std::uint16_t value) {
+    expand_runs(c);
+    if (auto *values = std::get_if<array_t>(&c.data)) {
+        const auto it = std::lower_bound(values->begin(), values->end(), value);
+        if (it != values->end() && *it == value) {
+            values->erase(it);
+            c.count--;
+        }
+        return;
+    }
+    auto &bits = std::get<bitmap_box>(c.data);
+    if ((*bits)[value]) {
+        (*bits)[value] = false;
+        if (--c.count <= k_max_array_size) {
+            c = from_bitmap(c.key, std::move(bits));
+        }
+    }
+}
+
+// Op is one of detail::and_op, or_op and xor_op
+template <class Op>
+container combine(const container &lhs, const container &rhs) {
+    const auto *lhs_values = std::get_if<array_t>(&lhs.data);
+    const auto *rhs_values = std::get_if<array_t>(&rhs.data);
+    if (lhs_values && rhs_values) {
+        array_t values;
+        auto out = std::back_inserter(values);
+        if constexpr (std::is_same_v<Op, and_op>) {
+            std::set_intersection(lhs_values->begin(), lhs_values->end(),
+                                  rhs_values->begin(), rhs_values->end(), out);
+        } else if constexpr (std::is_same_v<Op, or_op>) {
+            std::set_union(lhs_values->begin(), lhs_values->end(),
+                           rhs_values->begin(), rhs_values->end(), out);
+        } else {
+            std::set_symmetric_difference(lhs_values->begin(),
+                                          lhs_values->end(),
+                                          rhs_values->begin(),
+                                          rhs_values->end(), out);
+        }
+        return from_array(lhs.key, std::move(values));
+    }
+    if constexpr (std::is_same_v<Op, and_op>) {
+        // An intersection is no larger than its smaller side
+        if (lhs_values || rhs_values) {
+            const auto &values = lhs_values ? *lhs_values : *rhs_values;
+            const auto &other = lhs_values ? rhs : lhs;
+            array_t kept;
+            for (auto value : values) {
+                if (contains(other, value)) {
+                    kept.push_back(value);
+                }
+            }
+            return from_array(lhs.key, std::move(kept));
+        }
+    }
+    bitmap_box result;
+    with_bitmap(lhs, [&](const bitmap_t &lhs_bits) {
+        with_bitmap(rhs, [&](const bitmap_t &rhs_bits) {
+            Op::kernel(bytes(*result), bytes(lhs_bits), bytes(rhs_bits),
+                       sizeof(bitmap_t));
+        });
+    });
+    return from_bitmap(lhs.key, std::move(result));
+}
+
+inline std::size_t intersection_count(const container &lhs,
+                                      const container &rhs) {
+    const auto *lhs_values = std::get_if<array_t>(&lhs.data);
+    const auto *rhs_values = std::get_if<array_t>(&rhs.data);
+    if (lhs_values && rhs_values) {
+        std::size_t cnt{0};
+        auto l = lhs_values->begin();
+        auto r = rhs_values->begin();
+        while (l != lhs_values->end() && r != rhs_values->end()) {
+            if (*l < *r) {
+                ++l;
+            } else if (*r < *l) {
+                ++r;
+            } else {
+                ++cnt;
+                ++l;
+                ++r;
+            }
+        }
+        return cnt;
+    }
+    if (lhs_values || rhs_values) {
+        const auto &values = lhs_values ? *lhs_values : *rhs_values;
+        const auto &other = lhs_values ? rhs : lhs;
+        return static_cast<std::size_t>(
+            std::count_if(values.begin(), values.end(),
+                          [&other](std::uint16_t v) {
+                              return contains(other, v);
+                          }));
+    }
+    return with_bitmap(lhs, [&](const bitmap_t &lhs_bits) {
+        return with_bitmap(rhs, [&](const bitmap_t &rhs_bits) {
+            return lhs_bits.intersection_count(rhs_bits);
+        });
+    });
+}
+
+inline bool operator==(const container &lhs, const container &rhs) {
+    if (lhs.key != rhs.key || lhs.count != rhs.count) {
+        return false;
+    }
+    if (lhs.data.index() == rhs.data.index()) {
+        return lhs.data == rhs.data;
+    }
+    return intersection_count(lhs, rhs) == lhs.count;
+}
+
+// Converts the container to runs if they take less memory, or back from runs
+// if they no longer do
+inline void optimize(container &c) {
+    runs_t runs;
+    for_each_value(c, [&runs](std::uint16_t value) {
+        if (!runs.empty() && runs.back().last + 1 == value) {
+            runs.back().last = value;
+        } else {
+            runs.push_back(run{value, value});
+        }
+    });
+    const std::size_t dense_bytes =
+        std::min<std::size_t>(c.count * sizeof(std::uint16_t),
+                              sizeof(bitmap_t));
+    if (runs.size() * sizeof(run) < dense_bytes) {
+        runs.shrink_to_fit();
+        c.data = std::move(runs);
+    } else {
+        expand_runs(c);
+    }
+}
+
+inline std::size_t payload_bytes(const container &c) noexcept {
+    if (const auto *values = std::get_if<array_t>(&c.data)) {
+        return values->capacity() * sizeof(std::uint16_t);
+    }
+    if (std::holds_alternative<bitmap_box>(c.data)) {
+        return sizeof(bitmap_t);
+    }
+    return std::get<runs_t>(c.data).capacity() * sizeof(run);
+}
+
+} // namespace roaring
+} // namespace detail
+
+// A compressed set of 32-bit values, for sets that are sparse or made of long
+// runs within a large universe. The universe is split into chunks of 2^16
+// values and each non-empty chunk is held in the smallest of three
+// containers: a sorted array of up to 4096 values, a bitset<65536, uint64_t>
+// bitmap, or, after run_optimize(), a list of runs.
+//
+// Binary operations merge the chunks by key and pick a strategy per pair of
+// containers: set algorithms on two arrays, probing the other container for
+// an array, and the bitset kernels otherwise.
+class roaring_bitset {
+    using container = detail::roaring::container;
+
+    std::vector<container> m_containers;
+
+    static constexpr std::uint16_t key_of(std::size_t pos) noexcept {
+        return static_cast<std::uint16_t>(pos >> 16);
+    }
+
+    static constexpr std::uint16_t low_of(std::size_t pos) noexcept {
+        return static_cast<std::uint16_t>(pos & 0xffff);
+    }
+
+    static void check_pos(std::size_t pos, const char *what) {
+        if (pos >= std::size_t{1} << 32) {
+            throw std::out_of_range(std::string("roaring_bitset::") + what +
+                                    ": pos out of range");
+        }
+    }
+
+    auto lower_bound(std::uint16_t key) const {
+        return std::lower_bound(
+            m_containers.begin(), m_containers.end(), key,
+            [](const container &c, std::uint16_t k) { return c.key < k; });
+    }
+
+    auto lower_bound(std::uint16_t key) {
+        return std::lower_bound(
+            m_containers.begin(), m_containers.end(), key,
+            [](const container &c, std::uint16_t k) { return c.key < k; });
+    }
+
+    template <class Op>
+    static std::vector<container> merge(const roaring_bitset &lhs,
+                                        const roaring_bitset &rhs) {
+        constexpr bool keep_unmatched = !std::is_same_v<Op, detail::and_op>;
+        std::vector<container> result;
+        auto l = lhs.m_containers.begin();
+        auto r = rhs.m_containers.begin();
+        while (l != lhs.m_containers.end() && r != rhs.m_containers.end()) {
+            if (l->key < r->key) {
+                if (keep_unmatched) {
+                    result.push_back(*l);
+                }
+                ++l;
+            } else if (r->key < l->key) {
+                if (keep_unmatched) {
+                    result.push_back(*r);
+                }
+                ++r;
+            } else {
+                auto c = detail::roaring::combine<Op>(*l, *r);
+                if (c.count > 0) {
+                    result.push_back(std::move(c));
+                }
+                ++l;
+                ++r;
+            }
+        }
+        if (keep_unmatched) {
+            result.insert(result.end(), l, lhs.m_containers.end());
+            result.insert(result.end(), r, rhs.m_containers.end());
+        }
+        return result;
+    }
+
+  public:
+    roaring_bitset() = default;
+
+    roaring_bitset(std::initializer_list<std::uint32_t> values) {
+        for (auto value : values) {
+            set(value);
+        }
+    }
+
+    // Compresses a dense bitset one chunk at a time
+    template <std::size_t N, typename Underlying>
+    explicit roaring_bitset(const bitset<N, Underlying> &bits) {
+        static_assert(N <= (std::uint64_t{1} << 32),
+                      "roaring_bitset holds 32-bit values");
+        constexpr std::size_t kBits = 8 * sizeof(Underlying);
+        static_assert(kBits <= 64 && 64 % kBits == 0);
+        constexpr std::size_t kPerWord = 64 / kBits;
+        const auto &words = detail::bitset_access::words(bits);
+
+        detail::roaring::bitmap_box chunk;
+        for (std::size_t key = 0; key * detail::roaring::k_chunk_bits < N;
+             key++) {
+            auto &chunk_words = detail::bitset_access::words(*chunk);
+            const std::size_t first = key * chunk_words.size() * kPerWord;
+            bool empty = true;
+            for (std::size_t j = 0; j < chunk_words.size(); j++) {
+                std::uint64_t word{0};
+                for (std::size_t k = 0; k < kPerWord; k++) {
+                    const std::size_t i = first + j * kPerWord + k;
+                    if (i < words.size()) {
+                        word |= static_cast<std::uint64_t>(words[i])
+                                << (k * kBits);
+                    }
+                }
+                chunk_words[j] = word;
+                empty = empty && word == 0;
+            }
+            if (!empty) {
+                m_containers.push_back(detail::roaring::from_bitmap(
+                    static_cast<std::uint16_t>(key), std::move(chunk)));
+                chunk = detail::roaring::bitmap_box();
+            }
+        }
+    }
+
+    // The values as a dense bitset. Throws std::out_of_range if a value does
+    // not fit in N bits.
+    template <std::size_t N, typename Underlying = std::uint8_t>
+    bitset<N, Underlying> to_bitset() const {
+        constexpr std::size_t kBits = 8 * sizeof(Underlying);
+        static_assert(kBits <= 64 && 64 % kBits == 0);
+        constexpr std::size_t kPerWord = 64 / kBits;
+        if (!m_containers.empty() && find_last() >= N) {
+            throw std::out_of_range("roaring_bitset::to_bitset: value out of "
+                                    "range");
+        }
+
+        bitset<N, Underlying> bits;
+        auto &words = detail::bitset_access::words(bits);
+        for (const auto &c : m_containers) {
+            const std::size_t base = std::size_t{c.key} << 16;
+            if (const auto *box =
+                    std::get_if<detail::roaring::bitmap_box>(&c.data)) {
+                const auto &chunk_words = detail::bitset_access::words(**box);
+                const std::size_t first = base / kBits;
+                for (std::size_t j = 0; j < chunk_words.size(); j++) {
+                    for (std::size_t k = 0; k < kPerWord; k++) {
+                        const std::size_t i = first + j * kPerWord + k;
+                        if (i < words.size()) {
+                            words[i] = static_cast<Underlying>(
+                                chunk_words[j] >> (k * kBits));
+                        }
+                    }
+                }
+            } else {
+                detail::roaring::for_each_value(
+                    c, [&bits, base](std::uint16_t value) {
+                        bits[base + value] = true;
+                    });
+            }
+        }
+        return bits;
+    }
+
+    // The number of possible values, 2^32
+    constexpr std::size_t size() const noexcept { return std::size_t{1} << 32; }
+
+    bool test(std::size_t pos) const {
+        check_pos(pos, "test");
+        const auto it = lower_bound(key_of(pos));
+        return it != m_containers.end() && it->key == key_of(pos) &&
+               detail::roaring::contains(*it, low_of(pos));
+    }
+
+    bool operator[](std::size_t pos) const { return test(pos); }
+
+    roaring_bitset &set(std::size_t pos, bool value = true) {
+        check_pos(pos, "set");
+        if (!value) {
+            return reset(pos);
+        }
+        auto it = lower_bound(key_of(pos));
+        if (it == m_containers.end() || it->key != key_of(pos)) {
+            it = m_containers.insert(it, container{key_of(pos), 0, {}});
+        }
+        detail::roaring::add(*it, low_of(pos));
+        return *this;
+    }
+
+    roaring_bitset &reset(std::size_t pos) {
+        check_pos(pos, "reset");
+        const auto it = lower_bound(key_of(pos));
+        if (it != m_containers.end() && it->key == key_of(pos)) {
+            detail::roaring::remove(*it, low_of(pos));
+            if (it->count == 0) {
+                m_containers.erase(it);
+            }
+        }
+        return *this;
+    }
+
+    roaring_bitset &flip(std::size_t pos) {
+        check_pos(pos, "flip");
+        return set(pos, !test(pos));
+    }
+
+    roaring_bitset &reset() noexcept {
+        m_containers.clear();
+        return *this;
+    }
+
+    std::size_t count() const noexcept {
+        std::size_t cnt{0};
+        for (const auto &c : m_containers) {
+            cnt += c.count;
+        }
+        return cnt;
+    }
+
+    bool any() const noexcept { return !m_containers.empty(); }
+    bool none() const noexcept { return m_containers.empty(); }
+
+    // The find functions return size() if no matching bit is found
+    std::size_t find_first() const {
+        return m_containers.empty()
+                   ? size()
+                   : (std::size_t{m_containers.front().key} << 16) +
+                         detail::roaring::next_value(m_containers.front(), 0);
+    }
+
+    std::size_t find_next(std::size_t pos) const {
+        if (pos + 1 >= size()) {
+            return size();
+        }
+        pos++;
+        for (auto it = lower_bound(key_of(pos)); it != m_containers.end();
+             ++it) {
+            const std::size_t from = it->key == key_of(pos) ? low_of(pos) : 0;
+            const auto value = detail::roaring::next_value(*it, from);
+            if (value < detail::roaring::k_chunk_bits) {
+                return (std::size_t{it->key} << 16) + value;
+            }
+        }
+        return size();
+    }
+
+    std::size_t find_last() const {
+        return m_containers.empty()
+                   ? size()
+                   : (std::size_t{m_containers.back().key} << 16) +
+                         detail::roaring::last_value(m_containers.back());
+    }
+
+    roaring_bitset &operator&=(const roaring_bitset &rhs) {
+        m_containers = merge<detail::and_op>(*this, rhs);
+        return *this;
+    }
+
+    roaring_bitset &operator|=(const roaring_bitset &rhs) {
+        m_containers = merge<detail::or_op>(*this, rhs);
+        return *this;
+    }
+
+    roaring_bitset &operator^=(const roaring_bitset &rhs) {
+        m_containers = merge<detail::xor_op>(*this, rhs);
+        return *this;
+    }
+
+    friend roaring_bitset operator&(const roaring_bitset &lhs,
+                                    const roaring_bitset &rhs) {
+        roaring_bitset result;
+        result.m_containers = merge<detail::and_op>(lhs, rhs);
+        return result;
+    }
+
+    friend roaring_bitset operator|(const roaring_bitset &lhs,
+                                    const roaring_bitset &rhs) {
+        roaring_bitset result;
+        result.m_containers = merge<detail::or_op>(lhs, rhs);
+        return result;
+    }
+
+    friend roaring_bitset operator^(const roaring_bitset &lhs,
+                                    const roaring_bitset &rhs) {
+        roaring_bitset result;
+        result.m_containers = merge<detail::xor_op>(lhs, rhs);
+        return result;
+    }
+
+    // The binary counts do not build the combined set
+    std::size_t intersection_count(const roaring_bitset &other) const {
+        std::size_t cnt{0};
+        auto l = m_containers.begin();
+        auto r = other.m_containers.begin();
+        while (l != m_containers.end() && r != other.m_containers.end()) {
+            if (l->key < r->key) {
+                ++l;
+            } else if (r->key < l->key) {
+                ++r;
+            } else {
+                cnt += detail::roaring::intersection_count(*l, *r);
+                ++l;
+                ++r;
+            }
+        }
+        return cnt;
+    }
+
+    std::size_t union_count(const roaring_bitset &other) const {
+        return count() + other.count() - intersection_count(other);
+    }
+
+    std::size_t hamming_distance(const roaring_bitset &other) const {
+        return count() + other.count() - 2 * intersection_count(other);
+    }
+
+    bool intersects(const roaring_bitset &other) const {
+        return intersection_count(other) > 0;
+    }
+
+    // Stores every container that is cheaper as runs as runs. Returns
+    // whether any container now holds runs.
+    bool run_optimize() {
+        bool has_runs = false;
+        for (auto &c : m_containers) {
+            detail::roaring::optimize(c);
+            has_runs = has_runs ||
+                       std::holds_alternative<detail::roaring::runs_t>(c.data);
+        }
+        return has_runs;
+    }
+
+    // The memory held by the set, including its containers
+    std::size_t size_in_bytes() const noexcept {
+        std::size_t bytes = sizeof(*this) +
+                            m_containers.capacity() * sizeof(container);
+        for (const auto &c : m_containers) {
+            bytes += detail::roaring::payload_bytes(c);
+        }
+        return bytes;
+    }
+
+    bool operator==(const roaring_bitset &rhs) const {
+        return m_containers == rhs.m_containers;
+    }
+
+    bool operator!=(const roaring_bitset &rhs) const { return !(*this == rhs); }
+};
+
+} // namespace nonstd
@@ -3,6 +3,7 @@
 #include <gtest/gtest.h>
 #include <sstream>
 #include <stdexcept>
+#include <vector>
 
 using nonstd::bitset;
 
@@ -331,6 +332,278 @@ TYPED_TEST(Bitset, count) {
     }
 }
 
+TYPED_TEST(Bitset, count_large) {
+    bitset<1000, TypeParam> s;
+    std::size_t expected{0};
+    for (std::size_t i = 0; i < s.size(); i += 3) {
+        s.set(i);
+        ++expected;
+    }
+    ASSERT_EQ(s.count(), expected);
+
+    s.set();
+    ASSERT_EQ(s.count(), 1000);
+
+    bitset<129, TypeParam> uneven;
+    uneven.flip();
+    ASSERT_EQ(uneven.count(), 129);
+
+    constexpr bitset<129, TypeParam> ones{~0ull};
+    static_assert(ones.count() == 64);
+}
+
+// Checks every range operation on the len bits at pos against bit-by-bit
+// loops, starting from a pattern of set bits
+template <std::size_t N, typename T>
+void check_range(std::size_t pos, std::size_t len) {
+    bitset<N, T> pattern;
+    for (std::size_t i = 0; i < N; i += 3) {
+        pattern.set(i);
+    }
+    const auto in_range = [&](std::size_t i) {
+        return i >= pos && i - pos < len;
+    };
+
+    std::size_t expected_count{0};
+    bool expected_any{false};
+    bool expected_all{true};
+    for (std::size_t i = pos; i < pos + len; i++) {
+        expected_count += pattern[i];
+        expected_any |= pattern[i];
+        expected_all &= pattern[i];
+    }
+    ASSERT_EQ(pattern.count(pos, len), expected_count);
+    ASSERT_EQ(pattern.any_in(pos, len), expected_any);
+    ASSERT_EQ(pattern.all_in(pos, len), expected_all);
+
+    auto set = pattern, reset = pattern, flipped = pattern;
+    set.set(pos, len, true);
+    reset.reset(pos, len);
+    flipped.flip(pos, len);
+    for (std::size_t i = 0; i < N; i++) {
+        ASSERT_EQ(set[i], in_range(i) || pattern[i]) << "i: " << i;
+        ASSERT_EQ(reset[i], !in_range(i) && pattern[i]) << "i: " << i;
+        ASSERT_EQ(flipped[i], in_range(i) != pattern[i]) << "i: " << i;
+    }
+    ASSERT_EQ(set.count(), pattern.count() + len - expected_count);
+    ASSERT_EQ(reset.count(), pattern.count() - expected_count);
+    ASSERT_TRUE(set.all_in(pos, len));
+    ASSERT_FALSE(reset.any_in(pos, len));
+    ASSERT_EQ(set.set(pos, len, false), reset);
+}
+
+TYPED_TEST(Bitset, range_operations) {
+    constexpr std::size_t kBits{200};
+    for (std::size_t pos = 0; pos <= kBits; pos++) {
+        for (std::size_t len : {0, 1, 2, 7, 8, 9, 16, 33, 64, 65, 130}) {
+            if (len <= kBits - pos) {
+                check_range<kBits, TypeParam>(pos, len);
+            }
+        }
+        check_range<kBits, TypeParam>(pos, kBits - pos);
+    }
+    // Enough whole words in between for the kernels
+    check_range<3000, TypeParam>(5, 2990);
+    check_range<3000, TypeParam>(64, 2048);
+    check_range<3000, TypeParam>(0, 3000);
+
+    bitset<kBits, TypeParam> s;
+    ASSERT_THROW(s.set(kBits, 1, true), std::out_of_range);
+    ASSERT_THROW(s.reset(1, kBits), std::out_of_range);
+    ASSERT_THROW(s.flip(kBits + 1, 0), std::out_of_range);
+    ASSERT_THROW(s.count(0, kBits + 1), std::out_of_range);
+    ASSERT_THROW(s.any_in(5, ~std::size_t{0}), std::out_of_range);
+    ASSERT_THROW(s.all_in(kBits + 1, 0), std::out_of_range);
+    ASSERT_NO_THROW(s.set(kBits, 0, true));
+
+    constexpr auto constant = bitset<100, TypeParam>().set(3, 90, true);
+    static_assert(constant.count() == 90 && constant.count(0, 4) == 1);
+    static_assert(constant.all_in(3, 90) && !constant.any_in(93, 7));
+}
+
+// Checks extract and insert of every field of up to 64 bits against
+// bit-by-bit loops
+template <std::size_t N, typename T> void check_fields() {
+    bitset<N, T> pattern;
+    for (std::size_t i = 0; i < N; i++) {
+        pattern[i] = (i * 7 + i / 5) % 3 == 0;
+    }
+    for (std::size_t pos = 0; pos <= N; pos++) {
+        for (std::size_t len : {0, 1, 7, 8, 13, 32, 57, 63, 64}) {
+            if (len > N - pos) {
+                continue;
+            }
+            std::uint64_t expected{0};
+            for (std::size_t i = 0; i < len; i++) {
+                expected |= std::uint64_t{pattern[pos + i]} << i;
+            }
+            ASSERT_EQ(pattern.extract(pos, len), expected)
+                << "pos: " << pos << ", len: " << len;
+
+            // The high bits of the value are ignored
+            const std::uint64_t value = ~expected ^ 0x5555555555555555ull;
+            auto inserted = pattern;
+            inserted.insert(pos, len, value);
+            for (std::size_t i = 0; i < N; i++) {
+                const bool in_field = i >= pos && i - pos < len;
+                ASSERT_EQ(inserted[i],
+                          in_field ? (value >> (i - pos) & 1) != 0 : pattern[i])
+                    << "pos: " << pos << ", len: " << len << ", i: " << i;
+            }
+            ASSERT_EQ(inserted.insert(pos, len, expected), pattern);
+        }
+    }
+}
+
+TYPED_TEST(Bitset, extract_insert) {
+    check_fields<10, TypeParam>();
+    check_fields<64, TypeParam>();
+    check_fields<200, TypeParam>();
+    check_fields<512, TypeParam>();
+
+    bitset<512, TypeParam> header;
+    header.insert(3, 13, 0x1abc);
+    ASSERT_EQ(header.template extract<std::uint16_t>(3, 13), 0x1abc);
+    ASSERT_EQ((header.template extract<3, 13, std::uint16_t>()), 0x1abc);
+    header.template insert<500, 12>(0xfff);
+    ASSERT_EQ((header.template extract<499, 13>()), 0x1ffe);
+    ASSERT_EQ(header.count(), 8 + 12);
+
+    ASSERT_THROW(header.extract(500, 13), std::out_of_range);
+    ASSERT_THROW(header.insert(513, 0, 0), std::out_of_range);
+    ASSERT_THROW(header.template extract<std::uint8_t>(0, 9),
+                 std::invalid_argument);
+    ASSERT_THROW(header.insert(0, 65, 0), std::invalid_argument);
+
+    constexpr auto constant =
+        bitset<100, TypeParam>().insert(60, 20, 0xabcde);
+    static_assert(constant.extract(60, 20) == 0xabcde);
+    static_assert(constant.template extract<64, 8>() == 0xcd);
+    static_assert(constant.count() == 13);
+}
+
+TYPED_TEST(Bitset, find_first) {
+    bitset<kNumBits, TypeParam> s;
+    ASSERT_EQ(s.find_first(), kNumBits);
+    for (std::size_t i = 0; i < s.size(); i++) {
+        s.reset();
+        s.set(i);
+        s.set(kNumBits - 1);
+        ASSERT_EQ(s.find_first(), i);
+    }
+
+    constexpr bitset<kNumBits, TypeParam> constant(1ull << 40);
+    static_assert(constant.find_first() == 40);
+}
+
+TYPED_TEST(Bitset, find_next) {
+    bitset<kNumBits, TypeParam> s;
+    ASSERT_EQ(s.find_next(0), kNumBits);
+
+    const std::size_t positions[] = {0, 1, 7, 8, 9, 63, 64, 100, 127};
+    for (auto pos : positions) {
+        s.set(pos);
+    }
+    std::size_t found = s.find_first();
+    for (auto pos : positions) {
+        ASSERT_EQ(found, pos);
+        found = s.find_next(found);
+    }
+    ASSERT_EQ(found, kNumBits);
+    ASSERT_EQ(s.find_next(kNumBits), kNumBits);
+    ASSERT_EQ(s.find_next(kNumBits + 10), kNumBits);
+
+    bitset<23, TypeParam> uneven;
+    uneven.set(22);
+    ASSERT_EQ(uneven.find_next(0), 22);
+    ASSERT_EQ(uneven.find_next(22), 23);
+}
+
+TYPED_TEST(Bitset, find_last) {
+    bitset<kNumBits, TypeParam> s;
+    ASSERT_EQ(s.find_last(), kNumBits);
+    for (std::size_t i = 0; i < s.size(); i++) {
+        s.reset();
+        s.set(0);
+        s.set(i);
+        ASSERT_EQ(s.find_last(), i);
+    }
+
+    constexpr bitset<kNumBits, TypeParam> constant(1ull << 40 | 1);
+    static_assert(constant.find_last() == 40);
+}
+
+TYPED_TEST(Bitset, find_prev) {
+    bitset<kNumBits, TypeParam> s;
+    ASSERT_EQ(s.find_prev(kNumBits), kNumBits);
+
+    const std::size_t positions[] = {127, 100, 64, 63, 9, 8, 7, 1, 0};
+    for (auto pos : positions) {
+        s.set(pos);
+    }
+    std::size_t found = s.find_last();
+    for (auto pos : positions) {
+        ASSERT_EQ(found, pos);
+        found = s.find_prev(found);
+    }
+    ASSERT_EQ(found, kNumBits);
+    ASSERT_EQ(s.find_prev(0), kNumBits);
+    ASSERT_EQ(s.find_prev(kNumBits + 10), 127);
+
+    bitset<23, TypeParam> uneven;
+    uneven.set(0);
+    ASSERT_EQ(uneven.find_prev(23), 0);
+    ASSERT_EQ(uneven.find_prev(0), 23);
+}
+
+template <class Bits> constexpr std::size_t sum_of_set_bits(const Bits &bits) {
+    std::size_t sum{0};
+    for (auto pos : bits.set_bits()) {
+        sum += pos;
+    }
+    return sum;
+}
+
+TYPED_TEST(Bitset, set_bits) {
+    using set_bit_iterator =
+        typename bitset<kNumBits, TypeParam>::set_bit_iterator;
+    static_assert(
+        std::is_same_v<
+            typename std::iterator_traits<set_bit_iterator>::iterator_category,
+            std::forward_iterator_tag>);
+
+    bitset<kNumBits, TypeParam> s;
+    ASSERT_TRUE(s.set_bits().begin() == s.set_bits().end());
+
+    const std::vector<std::size_t> positions{0, 1, 7, 8, 9, 63, 64, 100, 127};
+    for (auto pos : positions) {
+        s.set(pos);
+    }
+
+    std::vector<std::size_t> found;
+    for (auto pos : s.set_bits()) {
+        found.push_back(pos);
+    }
+    ASSERT_EQ(found, positions);
+
+    auto range = s.set_bits();
+    ASSERT_EQ(std::distance(range.begin(), range.end()), s.count());
+    ASSERT_NE(std::find(range.begin(), range.end(), 100), range.end());
+    ASSERT_EQ(std::find(range.begin(), range.end(), 101), range.end());
+
+    auto iter = range.begin();
+    ASSERT_EQ(*iter++, 0);
+    ASSERT_EQ(*iter, 1);
+
+    bitset<23, TypeParam> uneven;
+    uneven.flip();
+    ASSERT_EQ(std::distance(uneven.set_bits().begin(), uneven.set_bits().end()),
+              23);
+
+    constexpr bitset<kNumBits, TypeParam> constant(1 | 1 << 10 | 1 << 20);
+    static_assert(sum_of_set_bits(constant) == 30);
+}
+
 TYPED_TEST(Bitset, size) {
     bitset<1, TypeParam> s_1;
     static_assert(s_1.size() == 1);
@@ -440,6 +713,102 @@ TYPED_TEST(Bitset, bitwise_not) {
     ASSERT_TRUE(inverse[3]);
 }
 
+TYPED_TEST(Bitset, bitwise_large) {
+    // Large enough for every vector width plus scalar tails
+    constexpr std::size_t kLarge{1000};
+    bitset<kLarge, TypeParam> evens;
+    bitset<kLarge, TypeParam> threes;
+    for (std::size_t i = 0; i < kLarge; i++) {
+        evens[i] = i % 2 == 0;
+        threes[i] = i % 3 == 0;
+    }
+
+    using large_bitset = bitset<kLarge, TypeParam>;
+    const large_bitset anded = evens & threes;
+    const large_bitset ored = evens | threes;
+    const large_bitset xored = evens ^ threes;
+    const large_bitset inverted = ~evens;
+    for (std::size_t i = 0; i < kLarge; i++) {
+        ASSERT_EQ(anded[i], i % 6 == 0) << "i: " << i;
+        ASSERT_EQ(ored[i], i % 2 == 0 || i % 3 == 0) << "i: " << i;
+        ASSERT_EQ(xored[i], (i % 2 == 0) != (i % 3 == 0)) << "i: " << i;
+        ASSERT_EQ(inverted[i], i % 2 != 0) << "i: " << i;
+    }
+    ASSERT_EQ(inverted.count(), kLarge / 2);
+
+    auto s = evens;
+    ASSERT_EQ(s &= threes, anded);
+    s = evens;
+    ASSERT_EQ(s |= threes, ored);
+    s = evens;
+    ASSERT_EQ(s ^= threes, xored);
+
+    ASSERT_NE(evens, threes);
+    s = evens;
+    s.flip(kLarge - 1);
+    ASSERT_NE(evens, s);
+
+    bitset<kLarge, TypeParam> none;
+    ASSERT_TRUE(none.none());
+    ASSERT_FALSE(none.any());
+    none.set(kLarge - 1);
+    ASSERT_FALSE(none.none());
+    ASSERT_TRUE(none.any());
+
+    bitset<kLarge, TypeParam> all;
+    all.set();
+    ASSERT_TRUE(all.all());
+    ASSERT_TRUE((~none | none).all());
+    all.reset(kLarge / 2);
+    ASSERT_FALSE(all.all());
+}
+
+TYPED_TEST(Bitset, binary_reductions) {
+    constexpr bitset<kNumBits, TypeParam> a{0b1111'0000};
+    constexpr bitset<kNumBits, TypeParam> b{0b1100'1100};
+    constexpr bitset<kNumBits, TypeParam> c{0b0000'0011};
+    static_assert(a.intersection_count(b) == 2);
+    static_assert(a.union_count(b) == 6);
+    static_assert(a.difference_count(b) == 2);
+    static_assert(a.hamming_distance(b) == 4);
+    static_assert(a.intersects(b) && !a.intersects(c));
+    static_assert(a.is_disjoint(c) && !a.is_disjoint(b));
+    static_assert((a & b).eval().is_subset_of(a) && !a.is_subset_of(b));
+
+    // Large enough for the vector kernels and the dispatch table
+    constexpr std::size_t kLarge{3000};
+    bitset<kLarge, TypeParam> lhs;
+    bitset<kLarge, TypeParam> rhs;
+    for (std::size_t i = 0; i < kLarge; i++) {
+        lhs[i] = i % 3 == 0;
+        rhs[i] = i % 5 == 0 || i == kLarge - 1;
+    }
+    ASSERT_EQ(lhs.intersection_count(rhs), (lhs & rhs).eval().count());
+    ASSERT_EQ(lhs.union_count(rhs), (lhs | rhs).eval().count());
+    ASSERT_EQ(lhs.difference_count(rhs), (lhs & ~rhs).eval().count());
+    ASSERT_EQ(lhs.hamming_distance(rhs), (lhs ^ rhs).eval().count());
+    ASSERT_EQ((lhs & rhs).count(), lhs.intersection_count(rhs));
+    ASSERT_EQ(lhs.hamming_distance(lhs), 0);
+    ASSERT_EQ(lhs.union_count(~lhs), kLarge);
+
+    ASSERT_TRUE(lhs.intersects(rhs));
+    ASSERT_TRUE((lhs & rhs).any());
+    ASSERT_FALSE((lhs & ~lhs).any());
+    ASSERT_FALSE(lhs.intersects(~lhs));
+    ASSERT_TRUE(lhs.is_disjoint(~lhs));
+    ASSERT_TRUE(lhs.is_subset_of(lhs | rhs));
+    ASSERT_FALSE(lhs.is_subset_of(rhs));
+
+    // Differences only in the last bit
+    bitset<kLarge, TypeParam> last;
+    last.set(kLarge - 1);
+    ASSERT_TRUE(last.intersects(rhs));
+    ASSERT_FALSE(last.intersects(lhs));
+    ASSERT_TRUE(last.is_subset_of(rhs));
+    ASSERT_FALSE(rhs.is_subset_of(last));
+    ASSERT_EQ(rhs.difference_count(last), rhs.count() - 1);
+}
+
 TYPED_TEST(Bitset, bitshift_left_first_bit) {
     for (auto i = 0; i < kNumBits; i++) {
         bitset<kNumBits, TypeParam> s;
@@ -679,6 +1048,96 @@ TYPED_TEST(Bitset, bitshift_right_multiple_bits_assignment) {
     }
 }
 
+TYPED_TEST(Bitset, bitshift_large) {
+    // Large enough to use the dispatched kernels
+    constexpr std::size_t kLarge{2500};
+    bitset<kLarge, TypeParam> s;
+    for (std::size_t i = 0; i < kLarge; i += 7) {
+        s.set(i);
+    }
+
+    for (std::size_t shift : {1, 3, 8, 13, 64, 100, 777, 2048, 2499}) {
+        const auto left = s << shift;
+        const auto right = s >> shift;
+        for (std::size_t i = 0; i < kLarge; i++) {
+            ASSERT_EQ(left[i], i >= shift && (i - shift) % 7 == 0)
+                << "shift: " << shift << ", i: " << i;
+            ASSERT_EQ(right[i], i + shift < kLarge && (i + shift) % 7 == 0)
+                << "shift: " << shift << ", i: " << i;
+        }
+    }
+}
+
+namespace {
+
+// Checks the shifts and rotations of a bitset holding every third bit and
+// the last one against the bits they should have moved
+template <std::size_t N, typename T> void check_shifts_and_rotations() {
+    bitset<N, T> s;
+    for (std::size_t i = 0; i < N; i += 3) {
+        s.set(i);
+    }
+    s.set(N - 1);
+    const auto expected = [&](std::size_t i) {
+        return i % 3 == 0 || i == N - 1;
+    };
+    for (std::size_t shift = 0; shift <= N + 1; shift++) {
+        const auto left = s << shift;
+        const auto right = s >> shift;
+        auto rotated_left = s;
+        rotated_left.rotl(shift);
+        auto rotated_right = s;
+        rotated_right.rotr(shift);
+        // The bits shifted past N must not linger above it
+        ASSERT_EQ(rotated_left.count(), s.count()) << "shift: " << shift;
+        ASSERT_EQ(rotated_right.count(), s.count()) << "shift: " << shift;
+        for (std::size_t i = 0; i < N; i++) {
+            ASSERT_EQ(left[i], i >= shift && expected(i - shift))
+                << "N: " << N << " shift: " << shift << ", i: " << i;
+            ASSERT_EQ(right[i], i + shift < N && expected(i + shift))
+                << "N: " << N << " shift: " << shift << ", i: " << i;
+            ASSERT_EQ(rotated_left[i], expected((i + N - shift % N) % N))
+                << "N: " << N << " shift: " << shift << ", i: " << i;
+            ASSERT_EQ(rotated_right[i], expected((i + shift) % N))
+                << "N: " << N << " shift: " << shift << ", i: " << i;
+        }
+    }
+}
+
+} // namespace
+
+TYPED_TEST(Bitset, bitshift_and_rotate_sizes) {
+    // A single word, a single 64-bit lane, and several lanes below the
+    // threshold of the dispatched kernels
+    check_shifts_and_rotations<1, TypeParam>();
+    check_shifts_and_rotations<13, TypeParam>();
+    check_shifts_and_rotations<64, TypeParam>();
+    check_shifts_and_rotations<65, TypeParam>();
+    check_shifts_and_rotations<200, TypeParam>();
+    check_shifts_and_rotations<1000, TypeParam>();
+}
+
+TYPED_TEST(Bitset, rotate_large) {
+    constexpr std::size_t kLarge{2500};
+    bitset<kLarge, TypeParam> s;
+    for (std::size_t i = 0; i < kLarge; i += 7) {
+        s.set(i);
+    }
+    for (std::size_t shift : {1, 8, 100, 2048, 2499, 2500, 7777}) {
+        auto rotated = s;
+        rotated.rotl(shift);
+        ASSERT_EQ(rotated.count(), s.count()) << "shift: " << shift;
+        for (std::size_t i = 0; i < kLarge; i++) {
+            ASSERT_EQ(rotated[(i + shift) % kLarge], s[i])
+                << "shift: " << shift << ", i: " << i;
+        }
+        ASSERT_EQ(rotated.rotr(shift), s) << "shift: " << shift;
+    }
+
+    constexpr auto constant = bitset<10, TypeParam>(0b1000000011).rotl(3);
+    static_assert(constant == bitset<10, TypeParam>(0b0000011100));
+}
+
 TYPED_TEST(Bitset, operator_equals_1) {
     bitset<1, TypeParam> s1(1);
     bitset<1, TypeParam> s2(1);
@@ -728,6 +1187,48 @@ TYPED_TEST(Bitset, to_string) {
     ASSERT_EQ(modified_data, s.to_string('O', 'X'));
 }
 
+TYPED_TEST(Bitset, string_round_trip_large) {
+    // Long enough for every vector width, with a partial last word
+    constexpr std::size_t kLargeBits{1000};
+    std::string data;
+    for (std::size_t i = 0; i < kLargeBits; i++) {
+        data += (i * i + i / 7) % 3 == 0 ? '1' : '0';
+    }
+
+    bitset<kLargeBits, TypeParam> s(data);
+    for (std::size_t i = 0; i < kLargeBits; i++) {
+        ASSERT_EQ(s[i], data[kLargeBits - 1 - i] == '1') << "i: " << i;
+    }
+    ASSERT_EQ(s.to_string(), data);
+    ASSERT_EQ((bitset<kLargeBits, TypeParam>(data.c_str())), s);
+
+    const std::string shorter = data.substr(0, 300);
+    ASSERT_EQ((bitset<kLargeBits, TypeParam>(data, 0, 300)),
+              (bitset<kLargeBits, TypeParam>(shorter.c_str())));
+    ASSERT_EQ((bitset<kLargeBits, TypeParam>(data, 0, 300)).to_string(),
+              std::string(kLargeBits - 300, '0') + shorter);
+
+    std::string alt(data);
+    std::replace(alt.begin(), alt.end(), '1', 'X');
+    std::replace(alt.begin(), alt.end(), '0', 'O');
+    ASSERT_EQ(s.to_string('O', 'X'), alt);
+    ASSERT_EQ((bitset<kLargeBits, TypeParam>(alt, 0, alt.npos, 'O', 'X')), s);
+
+    // An invalid character anywhere is reported, and only if it is read
+    for (std::size_t pos : {0, 1, 63, 500, 998, 999}) {
+        std::string invalid(data);
+        invalid[pos] = '2';
+        ASSERT_THROW((bitset<kLargeBits, TypeParam>(invalid)),
+                     std::invalid_argument)
+            << "pos: " << pos;
+        ASSERT_THROW((bitset<kLargeBits, TypeParam>(invalid.c_str())),
+                     std::invalid_argument)
+            << "pos: " << pos;
+        ASSERT_NO_THROW(
+            (bitset<kLargeBits, TypeParam>(invalid, pos + 1, kLargeBits)));
+    }
+}
+
 TYPED_TEST(Bitset, to_ulong) {
     constexpr auto kNumBitsInUnsignedLong = 8 * sizeof(unsigned long);
     constexpr auto value = 1ul << (kNumBitsInUnsignedLong - 1);
@@ -816,6 +1317,68 @@ TYPED_TEST(Bitset, free_operator_bitxor) {
     ASSERT_EQ(s1 ^ zero, s1);
 }
 
+TYPED_TEST(Bitset, expression_templates) {
+    constexpr bitset<kNumBits, TypeParam> a{0b1111'0000};
+    constexpr bitset<kNumBits, TypeParam> b{0b1100'1100};
+    constexpr bitset<kNumBits, TypeParam> c{0b1010'1010};
+    constexpr bitset<kNumBits, TypeParam> d{0b0000'1111};
+
+    constexpr bitset<kNumBits, TypeParam> fused = (a & b) | (~c ^ d);
+    static_assert(fused == ((a & b).eval() | ((~c).eval() ^ d)));
+    ASSERT_EQ(fused, (a & b).eval() | ((~c).eval() ^ d));
+    ASSERT_EQ(fused.count(), ((a & b) | (~c ^ d)).count());
+
+    static_assert((a & b).count() == 2);
+    static_assert((a & ~b).any());
+    static_assert((a & d).none());
+    static_assert((a | ~a).all());
+    static_assert(!(a | b).all());
+    static_assert((a ^ b)[2] && !(a ^ b)[6]);
+    ASSERT_EQ((a & b).count(), 2);
+    ASSERT_EQ((~a).count(), kNumBits - 4);
+    ASSERT_TRUE((~(a | b | c | d)).any());
+    ASSERT_TRUE((a & b) != (a & c));
+    ASSERT_TRUE((a & b) == (b & a));
+    ASSERT_EQ(a & b, 0b1100'0000);
+
+    // An expression offers the const interface of the bitset it evaluates to
+    ASSERT_TRUE((a ^ b).test(3));
+    ASSERT_FALSE((a ^ b).test(6));
+    ASSERT_THROW(static_cast<void>((a ^ b).test(kNumBits)), std::out_of_range);
+    ASSERT_EQ((~a).to_string(), (~a).eval().to_string());
+    ASSERT_EQ((a & b).to_string('.', '#'), (a & b).eval().to_string('.', '#'));
+    ASSERT_EQ((a | d).to_ulong(), 0b1111'1111ul);
+    static_assert((a | d).to_ullong() == 0b1111'1111ull);
+    ASSERT_THROW(static_cast<void>((~a).to_ullong()), std::overflow_error);
+    ASSERT_EQ((a & b) << 1, 0b1'1000'0000);
+    ASSERT_EQ((a & b) >> 6, 0b11);
+    static_assert(((a ^ d) >> 4) == 0b1111);
+    std::stringstream ss;
+    ss << (a & b);
+    ASSERT_EQ(ss.str(), (a & b).eval().to_string());
+
+    // The destination may also be an operand
+    bitset<kNumBits, TypeParam> s{a};
+    s = (s & b) | d;
+    ASSERT_EQ(s, 0b1100'1111);
+    s &= ~d;
+    ASSERT_EQ(s, 0b1100'0000);
+    s |= a ^ b;
+    ASSERT_EQ(s, 0b1111'1100);
+    s ^= ~a & b;
+    ASSERT_EQ(s, 0b1111'0000);
+    s = ~s;
+    ASSERT_EQ(s.count(), kNumBits - 4);
+
+    // Bits above N never leak into the result
+    bitset<10, TypeParam> uneven{0b11'0000'0000};
+    ASSERT_EQ((~uneven).count(), 8);
+    ASSERT_EQ((~uneven ^ uneven).count(), 10);
+    ASSERT_TRUE((~uneven | uneven).all());
+    uneven = ~uneven & ~uneven;
+    ASSERT_EQ(uneven, 0b00'1111'1111);
+}
+
 TYPED_TEST(Bitset, operator_stream_insert_extract) {
     std::string data("1111000010101010");
     data.insert(0, kNumBits - data.size(), '0');
@@ -860,6 +1423,163 @@ TYPED_TEST(Bitset, operator_stream_extraction_reset) {
     ASSERT_FALSE(bitset[3]) << bitset;
 }
 
+TYPED_TEST(Bitset, operator_stream_extract_bulk) {
+    constexpr std::size_t kLargeBits{1000};
+    std::string data;
+    for (std::size_t i = 0; i < kLargeBits; i++) {
+        data += (i * i + i / 7) % 3 == 0 ? '1' : '0';
+    }
+    const bitset<kLargeBits, TypeParam> expected(data);
+
+    // Whitespace separates bitsets, and a short read keeps the bits read
+    std::stringstream ss("  " + data + "1101\n 0110");
+    bitset<kLargeBits, TypeParam> bits;
+    ss >> bits;
+    ASSERT_EQ(bits, expected);
+    ss >> bits;
+    ASSERT_TRUE(ss.good());
+    ASSERT_EQ(bits, 0b1101);
+    ss >> bits;
+    ASSERT_EQ(bits, 0b0110);
+    ASSERT_TRUE(ss.eof());
+    ASSERT_FALSE(ss.fail());
+    ss >> bits;
+    ASSERT_TRUE(ss.fail());
+
+    std::wstringstream wide(L"1x01");
+    bitset<4, TypeParam> narrow;
+    wide >> narrow;
+    ASSERT_TRUE(wide.fail());
+    ASSERT_EQ(narrow, 1);
+    wide.clear();
+    wide >> narrow;
+    ASSERT_EQ(narrow, 0b01);
+}
+
+TYPED_TEST(Bitset, operator_stream_extract_small_buffer) {
+    // Hands out a few characters at a time, so the get area is refilled
+    // several times per bitset
+    class trickle_buf : public std::streambuf {
+      public:
+        explicit trickle_buf(std::string data) : m_data(std::move(data)) {}
+
+      protected:
+        int_type underflow() override {
+            if (m_pos == m_data.size()) {
+                return traits_type::eof();
+            }
+            const std::size_t n =
+                std::min<std::size_t>(5, m_data.size() - m_pos);
+            setg(&m_data[m_pos], &m_data[m_pos], &m_data[m_pos] + n);
+            m_pos += n;
+            return traits_type::to_int_type(*gptr());
+        }
+
+      private:
+        std::string m_data;
+        std::size_t m_pos{0};
+    };
+
+    const std::string data("110100111010110010111");
+    trickle_buf buf(data + "01");
+    std::istream is(&buf);
+    bitset<21, TypeParam> bits;
+    is >> bits;
+    ASSERT_EQ(bits, (bitset<21, TypeParam>(data)));
+    is >> bits;
+    ASSERT_EQ(bits, 0b01);
+    ASSERT_TRUE(is.eof());
+}
+
+TYPED_TEST(Bitset, operator_stream_extract_unbuffered) {
+    // Never sets up a get area, so every character comes from underflow()
+    // and uflow(), as with std::cin synced with stdio
+    class unbuffered_buf : public std::streambuf {
+      public:
+        explicit unbuffered_buf(std::string data) : m_data(std::move(data)) {}
+
+      protected:
+        int_type underflow() override {
+            return m_pos == m_data.size()
+                       ? traits_type::eof()
+                       : traits_type::to_int_type(m_data[m_pos]);
+        }
+
+        int_type uflow() override {
+            const int_type c = underflow();
+            if (!traits_type::eq_int_type(c, traits_type::eof())) {
+                m_pos++;
+            }
+            return c;
+        }
+
+      private:
+        std::string m_data;
+        std::size_t m_pos{0};
+    };
+
+    unbuffered_buf buf("1011 1x01 0110");
+    std::istream is(&buf);
+    bitset<8, TypeParam> bits;
+    is >> bits;
+    ASSERT_FALSE(is.fail());
+    ASSERT_EQ(bits, 0b1011);
+    is >> bits;
+    ASSERT_TRUE(is.fail());
+    ASSERT_EQ(bits, 1);
+    is.clear();
+    is >> bits;
+    ASSERT_EQ(bits, 0b01);
+    is >> bits;
+    ASSERT_EQ(bits, 0b0110);
+    ASSERT_TRUE(is.eof());
+}
+
+TYPED_TEST(Bitset, binary_format) {
+    constexpr std::size_t kBits{77};
+    std::string data;
+    for (std::size_t i = 0; i < kBits; i++) {
+        data += (i * i + i / 7) % 3 == 0 ? '1' : '0';
+    }
+    const bitset<kBits, TypeParam> bits(data);
+    static_assert(bitset<kBits, TypeParam>::byte_size() == 10);
+
+    std::vector<std::byte> bytes(bits.byte_size());
+    bits.write_to(bytes.data());
+    for (std::size_t i = 0; i < kBits; i++) {
+        ASSERT_EQ(((std::to_integer<unsigned>(bytes[i / 8]) >> (i % 8)) & 1) !=
+                      0,
+                  bits[i])
+            << "i: " << i;
+    }
+    const auto view = bits.as_bytes();
+    ASSERT_TRUE(std::equal(view.begin(), view.end(), bytes.begin(),
+                           bytes.end()));
+
+    // The format is shared by every Underlying type
+    ASSERT_EQ((bitset<kBits, std::uint8_t>::from_bytes(bytes)),
+              (bitset<kBits, std::uint8_t>(data)));
+    ASSERT_EQ((bitset<kBits, std::uint64_t>::from_bytes(bytes)),
+              (bitset<kBits, std::uint64_t>(data)));
+    bitset<kBits, TypeParam> read;
+    read.read_from(bytes.data());
+    ASSERT_EQ(read, bits);
+
+    // Bits above N are dropped
+    bytes.back() = std::byte{0xff};
+    read.read_from(bytes.data());
+    auto expected = bits;
+    for (std::size_t i = 72; i < kBits; i++) {
+        expected.set(i);
+    }
+    ASSERT_EQ(read, expected);
+    ASSERT_EQ(read, (bitset<kBits, TypeParam>::from_bytes(bytes)));
+
+    bytes.push_back(std::byte{0});
+    ASSERT_THROW((bitset<kBits, TypeParam>::from_bytes(bytes)),
+                 std::invalid_argument);
+}
+
 TYPED_TEST(Bitset, hash) {
     auto big_hash = std::hash<bitset<kNumBits, TypeParam>>();
 
@@ -878,3 +1598,39 @@ TYPED_TEST(Bitset, hash) {
     ASSERT_NE(small_hash(bitset<32, TypeParam>(1)),
               small_hash(bitset<32, TypeParam>(2)));
 }
+
+TYPED_TEST(Bitset, hash_quality) {
+    // The hash only depends on the bits, is usable at compile time and
+    // matches at runtime
+    using big_t = bitset<500, TypeParam>;
+    constexpr big_t constant("1011001110001111");
+    constexpr std::size_t constant_hash = std::hash<big_t>()(constant);
+    ASSERT_EQ(std::hash<big_t>()(constant), constant_hash);
+    ASSERT_EQ(constant_hash,
+              std::hash<bitset<500>>()(bitset<500>("1011001110001111")));
+
+    // Values of a few bits all hash differently
+    std::vector<std::size_t> hashes;
+    for (unsigned long long v = 0; v < 256; v++) {
+        hashes.push_back(std::hash<bitset<8, TypeParam>>()(v));
+        hashes.push_back(std::hash<bitset<9, TypeParam>>()(v));
+    }
+    std::sort(hashes.begin(), hashes.end());
+    ASSERT_EQ(std::adjacent_find(hashes.begin(), hashes.end()), hashes.end());
+
+    // Flipping any one bit changes about half of the hash bits
+    for (std::size_t n : {1, 64, 256}) {
+        bitset<256, TypeParam> bits(0x0123456789abcdefull);
+        bits <<= 100;
+        const auto hash = std::hash<bitset<256, TypeParam>>();
+        const auto base = hash(bits);
+        std::size_t changed{0};
+        for (std::size_t i = 0; i < n; i++) {
+            bits.flip(i);
+            changed += bitset<64, std::uint64_t>(hash(bits) ^ base).count();
+            bits.flip(i);
+        }
+        EXPECT_NEAR(static_cast<double>(changed) / n, 32.0, n == 1 ? 16 : 4)
+            << "n: " << n;
+    }
+}
@@ -0,0 +1,115 @@
+#include <atomic_bitset.hpp>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using nonstd::atomic_bitset;
+using nonstd::bitset;
+
+template <class T> class AtomicBitset : public testing::Test {};
+
+using UnsignedTypes =
+    ::testing::Types<std::uint8_t, std::uint16_t, std::uint32_t, std::uint64_t>;
+TYPED_TEST_SUITE(AtomicBitset, UnsignedTypes);
+
+namespace {
+constexpr std::size_t kNumBits{130};
+}
+
+TYPED_TEST(AtomicBitset, single_bit_operations) {
+    atomic_bitset<kNumBits, TypeParam> bits;
+    ASSERT_EQ(bits.size(), kNumBits);
+    ASSERT_TRUE(bits.none());
+
+    ASSERT_FALSE(bits.test_and_set(3));
+    ASSERT_TRUE(bits.test_and_set(3));
+    ASSERT_TRUE(bits.test(3));
+    ASSERT_TRUE(bits[3]);
+    ASSERT_TRUE(bits.test_and_reset(3));
+    ASSERT_FALSE(bits.test_and_reset(3));
+    ASSERT_FALSE(bits.test_and_flip(kNumBits - 1));
+    ASSERT_TRUE(bits.test(kNumBits - 1, std::memory_order_acquire));
+
+    bits.set(10).set(11, false).flip(12).reset(kNumBits - 1);
+    ASSERT_EQ(bits.count(), 2);
+    ASSERT_TRUE(bits.any());
+
+    ASSERT_THROW(bits.set(kNumBits), std::out_of_range);
+    ASSERT_THROW(bits.test_and_set(kNumBits), std::out_of_range);
+    ASSERT_THROW(bits.test_and_reset(kNumBits), std::out_of_range);
+    ASSERT_THROW(static_cast<void>(bits.test(kNumBits)), std::out_of_range);
+}
+
+TYPED_TEST(AtomicBitset, whole_bitset_operations) {
+    bitset<kNumBits, TypeParam> evens;
+    bitset<kNumBits, TypeParam> threes;
+    for (std::size_t i = 0; i < kNumBits; i++) {
+        evens[i] = i % 2 == 0;
+        threes[i] = i % 3 == 0;
+    }
+
+    atomic_bitset<kNumBits, TypeParam, std::memory_order_acq_rel> bits(evens);
+    ASSERT_EQ(bits.load(), evens);
+    ASSERT_EQ(bits.fetch_or(threes), evens);
+    ASSERT_EQ(bits.load(), (evens | threes).eval());
+    ASSERT_EQ(bits.fetch_and(threes), (evens | threes).eval());
+    ASSERT_EQ(bits.load(), threes);
+    ASSERT_EQ(bits.fetch_xor(evens), threes);
+    ASSERT_EQ(bits.load(), (evens ^ threes).eval());
+    ASSERT_EQ(bits.count(), (evens ^ threes).count());
+
+    bits.store(evens);
+    bits &= ~evens;
+    ASSERT_TRUE(bits.none());
+    bits |= threes;
+    bits ^= threes;
+    ASSERT_TRUE(bits.none());
+
+    bits.store(~bitset<kNumBits, TypeParam>{});
+    bitset<kNumBits, TypeParam> copy = bits;
+    ASSERT_TRUE(copy.all());
+    bits.reset();
+    ASSERT_EQ(bits.count(std::memory_order_seq_cst), 0);
+}
+
+TYPED_TEST(AtomicBitset, concurrent_claims) {
+    constexpr std::size_t kThreads{4};
+    constexpr std::size_t kBits{1000};
+    atomic_bitset<kBits, TypeParam> claimed;
+    std::atomic<std::size_t> wins{0};
+
+    // Every thread tries to claim every bit; each bit is won exactly once
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < kThreads; t++) {
+        threads.emplace_back([&] {
+            std::size_t won{0};
+            for (std::size_t i = 0; i < kBits; i++) {
+                won += !claimed.test_and_set(i, std::memory_order_acq_rel);
+            }
+            wins += won;
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQ(wins, kBits);
+    ASSERT_EQ(claimed.count(), kBits);
+
+    // Threads setting disjoint bits of the same words lose none of them
+    threads.clear();
+    claimed.reset();
+    for (std::size_t t = 0; t < kThreads; t++) {
+        threads.emplace_back([&, t] {
+            for (std::size_t i = t; i < kBits; i += kThreads) {
+                claimed.set(i, true, std::memory_order_relaxed);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQ(claimed.count(), kBits);
+}
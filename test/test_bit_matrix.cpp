@@ -0,0 +1,119 @@
+#include <bit_matrix.hpp>
+#include <gtest/gtest.h>
+
+#include <random>
+#include <stdexcept>
+
+using nonstd::bit_matrix;
+using nonstd::bitset;
+
+template <class T> class BitMatrix : public testing::Test {};
+
+using UnsignedTypes =
+    ::testing::Types<std::uint8_t, std::uint16_t, std::uint32_t, std::uint64_t>;
+TYPED_TEST_SUITE(BitMatrix, UnsignedTypes);
+
+namespace {
+
+template <class Matrix> Matrix make_random(std::uint32_t seed) {
+    std::mt19937 gen(seed);
+    Matrix m;
+    for (std::size_t r = 0; r < m.rows(); r++) {
+        for (std::size_t c = 0; c < m.cols(); c++) {
+            m.set(r, c, gen() % 3 == 0);
+        }
+    }
+    return m;
+}
+
+} // namespace
+
+TYPED_TEST(BitMatrix, transpose) {
+    // Sizes that are not multiples of the 64x64 blocks
+    using matrix_t = bit_matrix<70, 131, TypeParam>;
+    const auto m = make_random<matrix_t>(1);
+    const bit_matrix<131, 70, TypeParam> t = m.transpose();
+    for (std::size_t r = 0; r < m.rows(); r++) {
+        for (std::size_t c = 0; c < m.cols(); c++) {
+            ASSERT_EQ(t(c, r), m(r, c)) << "r: " << r << " c: " << c;
+        }
+    }
+    ASSERT_EQ(t.count(), m.count());
+    ASSERT_EQ(t.transpose(), m);
+
+    const auto small = make_random<bit_matrix<3, 5, TypeParam>>(2);
+    ASSERT_EQ(small.transpose().transpose(), small);
+    ASSERT_EQ(small.transpose()(4, 2), small(2, 4));
+}
+
+TYPED_TEST(BitMatrix, element_access) {
+    bit_matrix<10, 20, TypeParam> m;
+    ASSERT_EQ(m.count(), 0);
+    m.set(3, 19).set(9, 0).flip(0, 0).flip(9, 0).reset(3, 19).set(1, 2);
+    ASSERT_EQ(m.count(), 2);
+    ASSERT_TRUE(m.test(0, 0));
+    ASSERT_TRUE(m.test(1, 2));
+    ASSERT_TRUE(m.row(1)[2]);
+    ASSERT_THROW(m.test(10, 0), std::out_of_range);
+    ASSERT_THROW(m.set(0, 20), std::out_of_range);
+    ASSERT_THROW(m.flip(10, 20), std::out_of_range);
+}
+
+TYPED_TEST(BitMatrix, logical_operators) {
+    using matrix_t = bit_matrix<33, 100, TypeParam>;
+    const auto lhs = make_random<matrix_t>(1);
+    const auto rhs = make_random<matrix_t>(2);
+    const matrix_t and_result = lhs & rhs;
+    const matrix_t or_result = lhs | rhs;
+    const matrix_t xor_result = lhs ^ rhs;
+    for (std::size_t r = 0; r < lhs.rows(); r++) {
+        ASSERT_EQ(and_result.row(r), lhs.row(r) & rhs.row(r));
+        ASSERT_EQ(or_result.row(r), lhs.row(r) | rhs.row(r));
+        ASSERT_EQ(xor_result.row(r), lhs.row(r) ^ rhs.row(r));
+    }
+    ASSERT_NE(lhs, rhs);
+    ASSERT_EQ(xor_result ^ rhs, lhs);
+}
+
+TYPED_TEST(BitMatrix, matrix_vector_product) {
+    using matrix_t = bit_matrix<50, 130, TypeParam>;
+    const auto m = make_random<matrix_t>(1);
+    std::mt19937 gen(3);
+    bitset<130, TypeParam> v;
+    for (std::size_t i = 0; i < v.size(); i++) {
+        v[i] = gen() % 2 == 0;
+    }
+    const bitset<50, TypeParam> y = m * v;
+    for (std::size_t r = 0; r < m.rows(); r++) {
+        bool parity = false;
+        for (std::size_t c = 0; c < m.cols(); c++) {
+            parity ^= m(r, c) && v[c];
+        }
+        ASSERT_EQ(y[r], parity) << "r: " << r;
+    }
+    using square_t = bit_matrix<130, 130, TypeParam>;
+    ASSERT_EQ(square_t::identity() * v, v);
+}
+
+TYPED_TEST(BitMatrix, matrix_matrix_product) {
+    // An inner size that is not a multiple of the 8 rows of a table
+    const auto a = make_random<bit_matrix<20, 45, TypeParam>>(1);
+    const auto b = make_random<bit_matrix<45, 70, TypeParam>>(2);
+    const bit_matrix<20, 70, TypeParam> c = a * b;
+    for (std::size_t i = 0; i < a.rows(); i++) {
+        for (std::size_t j = 0; j < b.cols(); j++) {
+            bool sum = false;
+            for (std::size_t k = 0; k < a.cols(); k++) {
+                sum ^= a(i, k) && b(k, j);
+            }
+            ASSERT_EQ(c(i, j), sum) << "i: " << i << " j: " << j;
+        }
+    }
+    using inner_identity_t = bit_matrix<45, 45, TypeParam>;
+    using outer_identity_t = bit_matrix<20, 20, TypeParam>;
+    ASSERT_EQ(a * inner_identity_t::identity(), a);
+    ASSERT_EQ(outer_identity_t::identity() * a, a);
+
+    // (AB)^T = B^T A^T
+    ASSERT_EQ(c.transpose(), b.transpose() * a.transpose());
+}
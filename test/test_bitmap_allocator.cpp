@@ -0,0 +1,162 @@
+#include <bitmap_allocator.hpp>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+using nonstd::bitmap_allocator;
+
+template <class T> class BitmapAllocator : public testing::Test {};
+
+using UnsignedTypes =
+    ::testing::Types<std::uint8_t, std::uint16_t, std::uint32_t, std::uint64_t>;
+TYPED_TEST_SUITE(BitmapAllocator, UnsignedTypes);
+
+namespace {
+
+template <class Allocator> void allocate_all(Allocator &slots) {
+    std::vector<bool> seen(slots.size());
+    for (std::size_t i = 0; i < slots.size(); i++) {
+        const auto slot = slots.allocate();
+        ASSERT_LT(slot, slots.size());
+        ASSERT_FALSE(seen[slot]) << "slot: " << slot;
+        seen[slot] = true;
+    }
+    ASSERT_EQ(slots.allocate(), slots.size());
+    ASSERT_TRUE(slots.full());
+    ASSERT_EQ(slots.count(), slots.size());
+    ASSERT_TRUE(slots.allocated().all());
+}
+
+template <class Allocator> void allocate_and_release() {
+    auto slots = std::make_unique<Allocator>();
+    ASSERT_EQ(slots->count(), 0);
+    ASSERT_TRUE(slots->allocated().none());
+    allocate_all(*slots);
+
+    slots->deallocate(7);
+    slots->deallocate(slots->size() - 1);
+    ASSERT_FALSE(slots->is_allocated(7));
+    ASSERT_EQ(slots->count(), slots->size() - 2);
+    ASSERT_THROW(slots->deallocate(7), std::invalid_argument);
+    ASSERT_THROW(slots->deallocate(slots->size()), std::out_of_range);
+    ASSERT_THROW(static_cast<void>(slots->is_allocated(slots->size())),
+                 std::out_of_range);
+
+    std::vector<std::size_t> reclaimed{slots->allocate(), slots->allocate()};
+    std::sort(reclaimed.begin(), reclaimed.end());
+    ASSERT_EQ(reclaimed, (std::vector<std::size_t>{7, slots->size() - 1}));
+    ASSERT_EQ(slots->allocate(), slots->size());
+
+    slots->deallocate(3);
+    ASSERT_FALSE(slots->try_allocate(4));
+    ASSERT_TRUE(slots->try_allocate(3));
+    ASSERT_FALSE(slots->try_allocate(3));
+    ASSERT_THROW(slots->try_allocate(slots->size()), std::out_of_range);
+}
+
+} // namespace
+
+TYPED_TEST(BitmapAllocator, allocate_and_release) {
+    allocate_and_release<bitmap_allocator<130, TypeParam>>();
+    allocate_and_release<bitmap_allocator<1000, TypeParam>>();
+    allocate_and_release<bitmap_allocator<130, TypeParam, false>>();
+    allocate_and_release<bitmap_allocator<1000, TypeParam, false>>();
+}
+
+TYPED_TEST(BitmapAllocator, single_threaded_order) {
+    // Without concurrent threads the lowest free slot is handed out first
+    bitmap_allocator<200, TypeParam, false> slots;
+    for (std::size_t i = 0; i < 100; i++) {
+        ASSERT_EQ(slots.allocate(), i);
+    }
+    slots.deallocate(42);
+    slots.deallocate(10);
+    ASSERT_EQ(slots.allocate(), 10);
+    ASSERT_EQ(slots.allocate(), 42);
+    ASSERT_EQ(slots.allocate(), 100);
+
+    const auto bits = slots.allocated();
+    ASSERT_EQ(bits.count(), 101);
+    ASSERT_TRUE(bits.test(100));
+    ASSERT_FALSE(bits.test(101));
+}
+
+TYPED_TEST(BitmapAllocator, concurrent) {
+    constexpr std::size_t kSlots = 2000;
+    constexpr int kThreads = 4;
+    auto slots = std::make_unique<bitmap_allocator<kSlots, TypeParam>>();
+
+    // Every thread allocates until the allocator is full
+    std::vector<std::vector<std::size_t>> claimed(kThreads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; t++) {
+        threads.emplace_back([&slots, &mine = claimed[t]] {
+            for (auto slot = slots->allocate(); slot < kSlots;
+                 slot = slots->allocate()) {
+                mine.push_back(slot);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    ASSERT_TRUE(slots->full());
+
+    // Then each releases half of its slots while the others do the same
+    threads.clear();
+    for (int t = 0; t < kThreads; t++) {
+        threads.emplace_back([&slots, &mine = claimed[t]] {
+            for (std::size_t i = 0; i < mine.size(); i += 2) {
+                slots->deallocate(mine[i]);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    std::vector<int> owners(kSlots);
+    std::size_t kept{0};
+    for (const auto &mine : claimed) {
+        for (auto slot : mine) {
+            owners[slot]++;
+        }
+        kept += mine.size() / 2;
+    }
+    ASSERT_TRUE(std::all_of(owners.begin(), owners.end(),
+                            [](int owner) { return owner == 1; }));
+    ASSERT_EQ(slots->count(), kept);
+}
+
+TYPED_TEST(BitmapAllocator, allocated_as_bitset) {
+    // The slots in use come back as a bitset<N> for any word type, without
+    // the padding bits of the last word
+    static_assert(std::is_same_v<
+                  decltype(std::declval<bitmap_allocator<130, TypeParam>>()
+                               .allocated()),
+                  nonstd::bitset<130>>);
+    bitmap_allocator<130, TypeParam> slots;
+    nonstd::bitset<130> expected;
+    for (int i = 0; i < 70; i++) {
+        expected.set(slots.allocate());
+    }
+    ASSERT_EQ(expected.count(), 70);
+    ASSERT_EQ(slots.allocated(), expected);
+}
+
+TEST(BitmapAllocator, shared_thread_hint) {
+    // Allocators of one specialization share the hint of a thread, which
+    // must stay a valid starting word for each of them
+    bitmap_allocator<1000> first;
+    bitmap_allocator<1000> second;
+    allocate_all(first);
+    allocate_all(second);
+    second.deallocate(999);
+    ASSERT_EQ(second.allocate(), 999);
+}
@@ -0,0 +1,103 @@
+#include <bitset_array.hpp>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+using nonstd::bitset;
+using nonstd::bitset_array;
+
+template <class T> class BitsetArray : public testing::Test {};
+
+using UnsignedTypes =
+    ::testing::Types<std::uint8_t, std::uint16_t, std::uint32_t, std::uint64_t>;
+TYPED_TEST_SUITE(BitsetArray, UnsignedTypes);
+
+namespace {
+
+template <class Bits> Bits make_random(std::mt19937 &gen, unsigned density) {
+    Bits bits;
+    for (std::size_t i = 0; i < bits.size(); i++) {
+        bits[i] = gen() % density == 0;
+    }
+    return bits;
+}
+
+} // namespace
+
+TYPED_TEST(BitsetArray, rows) {
+    using bits_t = bitset<100, TypeParam>;
+    bitset_array<100, TypeParam> rows;
+    ASSERT_TRUE(rows.empty());
+
+    std::mt19937 gen(1);
+    std::vector<bits_t> reference;
+    for (int i = 0; i < 600; i++) {
+        reference.push_back(make_random<bits_t>(gen, 2));
+        rows.push_back(reference.back());
+    }
+    ASSERT_EQ(rows.size(), reference.size());
+    for (std::size_t r = 0; r < rows.size(); r++) {
+        ASSERT_EQ(rows[r], reference[r]) << "r: " << r;
+        ASSERT_EQ(rows.test(r, 99), reference[r][99]);
+    }
+
+    rows.assign(7, ~reference[7]);
+    ASSERT_EQ(rows.row(7), ~reference[7]);
+    ASSERT_THROW(rows.row(600), std::out_of_range);
+    ASSERT_THROW(rows.test(0, 100), std::out_of_range);
+
+    rows.resize(3);
+    rows.resize(5);
+    ASSERT_EQ(rows.row(2), reference[2]);
+    ASSERT_TRUE(rows.row(3).none());
+    ASSERT_TRUE(rows.row(4).none());
+}
+
+TYPED_TEST(BitsetArray, batched_queries) {
+    constexpr std::size_t kBits{256};
+    using bits_t = bitset<kBits, TypeParam>;
+    std::mt19937 gen(2);
+    std::vector<bits_t> reference;
+    bitset_array<kBits, TypeParam> rows;
+    // Not a multiple of the block size, and sparse rows so that some are
+    // subsets of the mask
+    for (int i = 0; i < 1000; i++) {
+        reference.push_back(make_random<bits_t>(gen, 40));
+        rows.push_back(reference.back());
+    }
+    const auto mask = make_random<bits_t>(gen, 2);
+
+    for (std::size_t threads : {1, 3}) {
+        const auto counts = rows.and_count_all(mask, threads);
+        ASSERT_EQ(counts.size(), reference.size());
+        for (std::size_t r = 0; r < reference.size(); r++) {
+            ASSERT_EQ(counts[r], (reference[r] & mask).count()) << "r: " << r;
+        }
+
+        std::vector<std::size_t> subsets;
+        for (std::size_t r = 0; r < reference.size(); r++) {
+            if (reference[r].is_subset_of(mask)) {
+                subsets.push_back(r);
+            }
+        }
+        ASSERT_FALSE(subsets.empty());
+        ASSERT_EQ(rows.filter_subset_of(mask, threads), subsets);
+
+        std::vector<std::pair<std::size_t, std::size_t>> distances;
+        for (std::size_t r = 0; r < reference.size(); r++) {
+            distances.emplace_back(reference[r].hamming_distance(mask), r);
+        }
+        std::sort(distances.begin(), distances.end());
+        const auto top = rows.hamming_top_k(mask, 10, threads);
+        ASSERT_EQ(top.size(), 10);
+        for (std::size_t i = 0; i < top.size(); i++) {
+            ASSERT_EQ(top[i].first, distances[i].second) << "i: " << i;
+            ASSERT_EQ(top[i].second, distances[i].first) << "i: " << i;
+        }
+    }
+    ASSERT_EQ(rows.hamming_top_k(mask, 5000).size(), reference.size());
+}
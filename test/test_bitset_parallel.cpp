@@ -0,0 +1,140 @@
+#include <bitset_parallel.hpp>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <random>
+#include <vector>
+
+using nonstd::bitset;
+using nonstd::thread_pool;
+namespace parallel = nonstd::parallel;
+
+template <class T> class BitsetParallel : public testing::Test {};
+
+using UnsignedTypes =
+    ::testing::Types<std::uint8_t, std::uint16_t, std::uint32_t, std::uint64_t>;
+TYPED_TEST_SUITE(BitsetParallel, UnsignedTypes);
+
+namespace {
+
+// Large enough for 4 chunks
+constexpr std::size_t kBits{std::size_t{1} << 23};
+
+template <class Bits> std::unique_ptr<Bits> make_random(std::uint32_t seed) {
+    std::mt19937 gen(seed);
+    std::vector<std::byte> bytes(Bits::byte_size());
+    for (auto &byte : bytes) {
+        byte = static_cast<std::byte>(gen());
+    }
+    auto bits = std::make_unique<Bits>();
+    bits->read_from(bytes.data());
+    return bits;
+}
+
+} // namespace
+
+TEST(ThreadPool, runs_every_task_once) {
+    for (std::size_t num_threads : {1, 2, 5}) {
+        thread_pool pool(num_threads);
+        ASSERT_EQ(pool.concurrency(), num_threads);
+        for (std::size_t n : {0, 1, 3, 100}) {
+            std::vector<std::atomic<int>> calls(n);
+            pool.bulk(n, [&](std::size_t i) { calls[i]++; });
+            for (std::size_t i = 0; i < n; i++) {
+                ASSERT_EQ(calls[i], 1) << "threads: " << num_threads
+                                       << " n: " << n << " i: " << i;
+            }
+        }
+    }
+}
+
+TYPED_TEST(BitsetParallel, reductions) {
+    using bits_t = bitset<kBits, TypeParam>;
+    thread_pool pool(4);
+    const auto bits = make_random<bits_t>(1);
+    ASSERT_EQ(parallel::count(pool, *bits), bits->count());
+    ASSERT_TRUE(parallel::any(pool, *bits));
+    ASSERT_FALSE(parallel::none(pool, *bits));
+    ASSERT_FALSE(parallel::all(pool, *bits));
+    ASSERT_EQ(parallel::find_first(pool, *bits), bits->find_first());
+
+    auto other = std::make_unique<bits_t>(*bits);
+    ASSERT_TRUE(parallel::equal(pool, *bits, *other));
+    other->flip(kBits - 1);
+    ASSERT_FALSE(parallel::equal(pool, *bits, *other));
+
+    // A single bit, in the last chunk
+    auto single = std::make_unique<bits_t>();
+    ASSERT_FALSE(parallel::any(pool, *single));
+    ASSERT_TRUE(parallel::none(pool, *single));
+    ASSERT_EQ(parallel::find_first(pool, *single), kBits);
+    single->set(kBits - 3);
+    ASSERT_EQ(parallel::count(pool, *single), 1);
+    ASSERT_TRUE(parallel::any(pool, *single));
+    ASSERT_EQ(parallel::find_first(pool, *single), kBits - 3);
+
+    auto ones = std::make_unique<bits_t>();
+    ones->set();
+    ASSERT_TRUE(parallel::all(pool, *ones));
+    ASSERT_EQ(parallel::count(pool, *ones), kBits);
+    ones->reset(kBits - 1);
+    ASSERT_FALSE(parallel::all(pool, *ones));
+    ones->set(kBits - 1).reset(kBits / 2);
+    ASSERT_FALSE(parallel::all(pool, *ones));
+}
+
+TYPED_TEST(BitsetParallel, logical_operators) {
+    using bits_t = bitset<kBits, TypeParam>;
+    thread_pool pool(4);
+    const auto lhs = make_random<bits_t>(1);
+    const auto rhs = make_random<bits_t>(2);
+
+    auto expected = std::make_unique<bits_t>(*lhs);
+    auto result = std::make_unique<bits_t>(*lhs);
+    *expected &= *rhs;
+    ASSERT_TRUE(parallel::and_assign(pool, *result, *rhs) == *expected);
+    *expected |= *lhs;
+    ASSERT_TRUE(parallel::or_assign(pool, *result, *lhs) == *expected);
+    *expected ^= *rhs;
+    ASSERT_TRUE(parallel::xor_assign(pool, *result, *rhs) == *expected);
+    expected->flip();
+    ASSERT_TRUE(parallel::flip(pool, *result) == *expected);
+}
+
+TYPED_TEST(BitsetParallel, shifts) {
+    using bits_t = bitset<kBits, TypeParam>;
+    thread_pool pool(4);
+    const auto bits = make_random<bits_t>(1);
+    auto expected = std::make_unique<bits_t>();
+    auto result = std::make_unique<bits_t>();
+    for (std::size_t shift :
+         {std::size_t{0}, std::size_t{1}, std::size_t{7}, std::size_t{8},
+          std::size_t{63}, std::size_t{64}, std::size_t{12345},
+          8 * parallel::k_min_chunk_bytes + 3, kBits - 1, kBits}) {
+        *expected = *bits;
+        *expected <<= shift;
+        *result = *bits;
+        ASSERT_TRUE(parallel::shift_left(pool, *result, shift) == *expected)
+            << "shift: " << shift;
+
+        *expected = *bits;
+        *expected >>= shift;
+        *result = *bits;
+        ASSERT_TRUE(parallel::shift_right(pool, *result, shift) == *expected)
+            << "shift: " << shift;
+    }
+}
+
+TYPED_TEST(BitsetParallel, small_is_serial) {
+    thread_pool pool(4);
+    bitset<100, TypeParam> bits(0b1011000);
+    bitset<100, TypeParam> other(0b0001111);
+    ASSERT_EQ(parallel::count(pool, bits), 3);
+    ASSERT_EQ(parallel::find_first(pool, bits), 3);
+    ASSERT_EQ(parallel::or_assign(pool, bits, other), 0b1011111);
+    ASSERT_EQ(parallel::shift_left(pool, bits, 2), 0b101111100);
+    other.set();
+    ASSERT_TRUE(parallel::all(pool, other));
+    ASSERT_TRUE(parallel::none(pool, parallel::flip(pool, other)));
+}
@@ -0,0 +1,119 @@
+#include <bitset_view.hpp>
+#include <gtest/gtest.h>
+
+#include <random>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+using nonstd::bitset;
+using nonstd::bitset_view;
+using nonstd::const_bitset_view;
+
+template <class T> class BitsetView : public testing::Test {};
+
+using UnsignedTypes =
+    ::testing::Types<std::uint8_t, std::uint16_t, std::uint32_t, std::uint64_t>;
+TYPED_TEST_SUITE(BitsetView, UnsignedTypes);
+
+namespace {
+
+template <class Bits> Bits make_random(std::uint32_t seed) {
+    std::mt19937 gen(seed);
+    Bits bits;
+    for (std::size_t i = 0; i < bits.size(); i++) {
+        bits[i] = gen() % 3 == 0;
+    }
+    return bits;
+}
+
+} // namespace
+
+static_assert(!std::is_constructible_v<bitset_view<8>, const bitset<8> &>,
+              "A mutable view of a const bitset");
+static_assert(std::is_convertible_v<bitset_view<8>, const_bitset_view<8>>);
+static_assert(!std::is_convertible_v<const_bitset_view<8>, bitset_view<8>>);
+
+TYPED_TEST(BitsetView, queries_match_bitset) {
+    constexpr std::size_t kBits{1000};
+    using bits_t = bitset<kBits, TypeParam>;
+    const auto reference = make_random<bits_t>(1);
+
+    // The view reads words copied out of the bitset, as from a mapped file
+    std::vector<TypeParam> memory(bitset_view<kBits, TypeParam>::num_words());
+    reference.write_to(reinterpret_cast<std::byte *>(memory.data()));
+    const const_bitset_view<kBits, TypeParam> view(memory.data());
+
+    ASSERT_EQ(view.to_bitset(), reference);
+    ASSERT_EQ(view.count(), reference.count());
+    ASSERT_EQ(view.any(), reference.any());
+    ASSERT_EQ(view.all(), reference.all());
+    ASSERT_EQ(view.find_first(), reference.find_first());
+    ASSERT_EQ(view.find_last(), reference.find_last());
+    for (std::size_t i = 0; i < kBits; i++) {
+        ASSERT_EQ(view[i], reference[i]) << "i: " << i;
+        ASSERT_EQ(view.find_next(i), reference.find_next(i)) << "i: " << i;
+        ASSERT_EQ(view.find_prev(i), reference.find_prev(i)) << "i: " << i;
+    }
+    ASSERT_THROW(view.test(kBits), std::out_of_range);
+
+    const auto other = make_random<bits_t>(2);
+    ASSERT_EQ(view.intersection_count(other),
+              reference.intersection_count(other));
+    ASSERT_EQ(view.hamming_distance(other), reference.hamming_distance(other));
+    ASSERT_EQ(view.intersects(other), reference.intersects(other));
+    ASSERT_EQ(view.is_subset_of(other), reference.is_subset_of(other));
+    ASSERT_TRUE(view.is_subset_of(bits_t(reference | other)));
+    ASSERT_TRUE(view == reference);
+    ASSERT_TRUE(view != other);
+}
+
+TYPED_TEST(BitsetView, modifies_in_place) {
+    constexpr std::size_t kBits{1000};
+    using bits_t = bitset<kBits, TypeParam>;
+    const auto lhs = make_random<bits_t>(1);
+    const auto rhs = make_random<bits_t>(2);
+
+    bits_t bits = lhs;
+    bitset_view<kBits, TypeParam> view(bits);
+    view &= rhs;
+    ASSERT_EQ(bits, lhs & rhs);
+    view |= rhs;
+    ASSERT_EQ(bits, (lhs & rhs) | rhs);
+    view ^= lhs;
+    ASSERT_EQ(bits, ((lhs & rhs) | rhs) ^ lhs);
+
+    // Between two views of external memory
+    std::vector<TypeParam> memory(bitset_view<kBits, TypeParam>::num_words());
+    bitset_view<kBits, TypeParam> target(memory.data());
+    ASSERT_TRUE(target.none());
+    target.assign(view);
+    ASSERT_TRUE(target == view);
+    target.flip();
+    ASSERT_EQ(target.to_bitset(), ~bits);
+    ASSERT_EQ(target.count(), kBits - bits.count());
+    target.set();
+    ASSERT_TRUE(target.all());
+    ASSERT_EQ(target.count(), kBits);
+    target.reset();
+    ASSERT_TRUE(target.none());
+
+    target.set(3).set(999).flip(4).reset(3);
+    ASSERT_EQ(target.count(), 2);
+    ASSERT_TRUE(target.test(4));
+    ASSERT_TRUE(target.test(999));
+    ASSERT_THROW(target.set(kBits), std::out_of_range);
+    ASSERT_THROW(target.flip(kBits), std::out_of_range);
+}
+
+TYPED_TEST(BitsetView, small) {
+    bitset<10, TypeParam> bits(0b1000000101);
+    bitset_view<10, TypeParam> view(bits);
+    ASSERT_EQ(view.count(), 3);
+    ASSERT_EQ(view.find_last(), 9);
+    view.flip();
+    ASSERT_EQ(bits, 0b0111111010);
+    view.set();
+    ASSERT_TRUE(bits.all());
+    ASSERT_TRUE(view.all());
+}
@@ -0,0 +1,248 @@
+#include <bitset_dispatch.hpp>
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+using nonstd::detail::dispatch::isa;
+using nonstd::detail::dispatch::kernel_table;
+
+namespace {
+
+std::vector<unsigned char> random_bytes(std::size_t n, std::uint32_t seed) {
+    std::mt19937 gen(seed);
+    std::vector<unsigned char> bytes(n);
+    for (auto &byte : bytes) {
+        byte = static_cast<unsigned char>(gen());
+    }
+    return bytes;
+}
+
+bool bit(const std::vector<unsigned char> &bytes, std::size_t i) {
+    return i < 8 * bytes.size() && ((bytes[i / 8] >> (i % 8)) & 1) != 0;
+}
+
+// Buffer sizes around every vector width
+const std::size_t kSizes[] = {0,  1,  7,   8,   9,   15,  16,  17,  31,
+                              32, 33, 63,  64,  65,  100, 127, 128, 129,
+                              255, 256, 257, 1000};
+
+} // namespace
+
+class Dispatch : public testing::TestWithParam<isa> {
+  protected:
+    void SetUp() override {
+        if (!nonstd::detail::dispatch::supported(GetParam())) {
+            GTEST_SKIP() << "Instruction set not supported by this CPU";
+        }
+    }
+
+    const kernel_table &kernels() const {
+        return nonstd::detail::dispatch::kernels_for(GetParam());
+    }
+};
+
+INSTANTIATE_TEST_SUITE_P(Isa, Dispatch,
+                         testing::Values(isa::native, isa::popcnt, isa::avx2,
+                                         isa::avx512));
+
+TEST_P(Dispatch, count) {
+    for (auto n : kSizes) {
+        const auto bytes = random_bytes(n, n);
+        std::size_t expected{0};
+        for (std::size_t i = 0; i < 8 * n; i++) {
+            expected += bit(bytes, i);
+        }
+        ASSERT_EQ(kernels().count(bytes.data(), n), expected) << "n: " << n;
+    }
+}
+
+TEST_P(Dispatch, logical_ops) {
+    for (auto n : kSizes) {
+        const auto lhs = random_bytes(n, 1);
+        const auto rhs = random_bytes(n, 2);
+        std::vector<unsigned char> out(n);
+
+        kernels().bit_and(out.data(), lhs.data(), rhs.data(), n);
+        for (std::size_t i = 0; i < n; i++) {
+            ASSERT_EQ(out[i], lhs[i] & rhs[i]) << "n: " << n << ", i: " << i;
+        }
+        kernels().bit_or(out.data(), lhs.data(), rhs.data(), n);
+        for (std::size_t i = 0; i < n; i++) {
+            ASSERT_EQ(out[i], lhs[i] | rhs[i]) << "n: " << n << ", i: " << i;
+        }
+        kernels().bit_xor(out.data(), lhs.data(), rhs.data(), n);
+        for (std::size_t i = 0; i < n; i++) {
+            ASSERT_EQ(out[i], lhs[i] ^ rhs[i]) << "n: " << n << ", i: " << i;
+        }
+        kernels().invert(out.data(), lhs.data(), n);
+        for (std::size_t i = 0; i < n; i++) {
+            ASSERT_EQ(out[i], static_cast<unsigned char>(~lhs[i]))
+                << "n: " << n << ", i: " << i;
+        }
+    }
+}
+
+TEST_P(Dispatch, comparisons) {
+    for (auto n : kSizes) {
+        auto bytes = random_bytes(n, 1);
+        auto copy = bytes;
+        ASSERT_TRUE(kernels().equal(bytes.data(), copy.data(), n));
+        if (n > 0) {
+            copy[n - 1] ^= 0x80;
+            ASSERT_FALSE(kernels().equal(bytes.data(), copy.data(), n));
+        }
+
+        std::vector<unsigned char> zeros(n, 0);
+        ASSERT_FALSE(kernels().any(zeros.data(), n));
+        std::vector<unsigned char> ones(n, 0xff);
+        ASSERT_TRUE(kernels().all_ones(ones.data(), n));
+        if (n > 0) {
+            zeros[n - 1] = 1;
+            ASSERT_TRUE(kernels().any(zeros.data(), n));
+            ones[n / 2] = 0xfe;
+            ASSERT_FALSE(kernels().all_ones(ones.data(), n));
+        }
+    }
+}
+
+TEST_P(Dispatch, find_first) {
+    for (auto n : kSizes) {
+        std::vector<unsigned char> bytes(n, 0);
+        ASSERT_EQ(kernels().find_first(bytes.data(), n), 8 * n);
+        for (std::size_t i = 0; i < 8 * n; i += 5) {
+            std::fill(bytes.begin(), bytes.end(), 0);
+            bytes[i / 8] = static_cast<unsigned char>(1u << (i % 8));
+            bytes[n - 1] |= 0x80;
+            ASSERT_EQ(kernels().find_first(bytes.data(), n), i)
+                << "n: " << n << ", i: " << i;
+        }
+    }
+}
+
+TEST_P(Dispatch, shifts) {
+    for (auto n : kSizes) {
+        const auto bytes = random_bytes(n, 3);
+        for (std::size_t shift : {0, 1, 5, 8, 9, 64, 67, 130, 800, 8000}) {
+            auto left = bytes;
+            kernels().shift_left(left.data(), n, shift);
+            auto right = bytes;
+            kernels().shift_right(right.data(), n, shift);
+            for (std::size_t i = 0; i < 8 * n; i++) {
+                ASSERT_EQ(bit(left, i), i >= shift && bit(bytes, i - shift))
+                    << "n: " << n << ", shift: " << shift << ", i: " << i;
+                ASSERT_EQ(bit(right, i), bit(bytes, i + shift))
+                    << "n: " << n << ", shift: " << shift << ", i: " << i;
+            }
+        }
+    }
+}
+
+TEST_P(Dispatch, fused_reductions) {
+    for (auto n : kSizes) {
+        const auto lhs = random_bytes(n, 1);
+        const auto rhs = random_bytes(n, 2);
+        std::size_t ands{0}, ors{0}, xors{0}, and_nots{0};
+        for (std::size_t i = 0; i < 8 * n; i++) {
+            ands += bit(lhs, i) && bit(rhs, i);
+            ors += bit(lhs, i) || bit(rhs, i);
+            xors += bit(lhs, i) != bit(rhs, i);
+            and_nots += bit(lhs, i) && !bit(rhs, i);
+        }
+        ASSERT_EQ(kernels().count_and(lhs.data(), rhs.data(), n), ands);
+        ASSERT_EQ(kernels().count_or(lhs.data(), rhs.data(), n), ors);
+        ASSERT_EQ(kernels().count_xor(lhs.data(), rhs.data(), n), xors);
+        ASSERT_EQ(kernels().count_and_not(lhs.data(), rhs.data(), n),
+                  and_nots);
+
+        // A single shared bit, in the last byte so every block is scanned
+        std::vector<unsigned char> a(n, 0x55);
+        std::vector<unsigned char> b(n, 0xaa);
+        ASSERT_FALSE(kernels().any_and(a.data(), b.data(), n));
+        ASSERT_EQ(kernels().any_and_not(a.data(), b.data(), n), n > 0);
+        ASSERT_FALSE(kernels().any_and_not(a.data(), a.data(), n));
+        if (n > 0) {
+            b[n - 1] |= 0x01;
+            ASSERT_TRUE(kernels().any_and(a.data(), b.data(), n));
+            a[n - 1] = 0;
+            b = a;
+            b[n - 1] = 0x10;
+            ASSERT_TRUE(kernels().any_and_not(b.data(), a.data(), n));
+        }
+    }
+}
+
+TEST_P(Dispatch, text) {
+    for (auto n : kSizes) {
+        const auto bytes = random_bytes(n, 4);
+        // Every bit count up to a byte short of the buffer
+        for (std::size_t num_bits = 8 * n > 7 ? 8 * n - 7 : 0;
+             num_bits <= 8 * n; num_bits++) {
+            std::vector<unsigned char> chars(num_bits);
+            kernels().format_bits(chars.data(), bytes.data(), num_bits, 'O',
+                                  'X');
+            for (std::size_t i = 0; i < num_bits; i++) {
+                ASSERT_EQ(chars[num_bits - 1 - i], bit(bytes, i) ? 'X' : 'O')
+                    << "num_bits: " << num_bits << ", i: " << i;
+            }
+
+            std::vector<unsigned char> parsed((num_bits + 7) / 8);
+            ASSERT_EQ(kernels().parse_bits(parsed.data(), chars.data(),
+                                           num_bits, 'O', 'X'),
+                      num_bits);
+            for (std::size_t i = 0; i < num_bits; i++) {
+                ASSERT_EQ(bit(parsed, i), bit(bytes, i))
+                    << "num_bits: " << num_bits << ", i: " << i;
+            }
+            for (std::size_t i = num_bits; i < 8 * parsed.size(); i++) {
+                ASSERT_FALSE(bit(parsed, i)) << "num_bits: " << num_bits;
+            }
+
+            for (std::size_t i = 0; i < num_bits; i += 3) {
+                auto invalid = chars;
+                invalid[i] = '0';
+                ASSERT_EQ(kernels().parse_bits(parsed.data(), invalid.data(),
+                                               num_bits, 'O', 'X'),
+                          i)
+                    << "num_bits: " << num_bits;
+            }
+        }
+    }
+}
+
+TEST_P(Dispatch, span_bits) {
+    for (auto n : kSizes) {
+        std::vector<unsigned char> chars(n);
+        for (std::size_t i = 0; i < n; i++) {
+            chars[i] = i % 3 == 0 ? 'X' : 'O';
+        }
+        ASSERT_EQ(kernels().span_bits(chars.data(), n, 'O', 'X'), n);
+        for (std::size_t i = 0; i < n; i++) {
+            auto invalid = chars;
+            invalid[i] = 'P';
+            ASSERT_EQ(kernels().span_bits(invalid.data(), n, 'O', 'X'), i)
+                << "n: " << n;
+        }
+    }
+}
+
+TEST_P(Dispatch, column_count) {
+    for (auto n : kSizes) {
+        const auto bytes = random_bytes(8 * n, 5);
+        std::vector<std::uint64_t> column(n);
+        std::memcpy(column.data(), bytes.data(), bytes.size());
+        const std::uint64_t operand = 0x0123456789abcdefull;
+
+        std::vector<std::uint64_t> ands(n, 1);
+        std::vector<std::uint64_t> xors(n, 0);
+        kernels().column_count_and(ands.data(), column.data(), operand, n);
+        kernels().column_count_xor(xors.data(), column.data(), operand, n);
+        for (std::size_t r = 0; r < n; r++) {
+            ASSERT_EQ(ands[r], 1 + __builtin_popcountll(column[r] & operand))
+                << "n: " << n << ", r: " << r;
+            ASSERT_EQ(xors[r], __builtin_popcountll(column[r] ^ operand))
+                << "n: " << n << ", r: " << r;
+        }
+    }
+}
@@ -0,0 +1,351 @@
+#include <dynamic_bitset.hpp>
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+using nonstd::dynamic_bitset;
+
+template <class T> class DynamicBitset : public testing::Test {};
+
+using UnsignedTypes =
+    ::testing::Types<std::uint8_t, std::uint16_t, std::uint32_t, std::uint64_t>;
+TYPED_TEST_SUITE(DynamicBitset, UnsignedTypes);
+
+namespace {
+
+// Sizes on both sides of the inline buffer and the vector widths
+const std::size_t kSizes[] = {0, 1, 7, 8, 9, 63, 64, 65, 129, 1000, 3000};
+
+template <class Bits> Bits make_pattern(std::size_t n) {
+    Bits bits(n);
+    for (std::size_t i = 0; i < n; i++) {
+        bits[i] = i % 3 == 0 || i % 7 == 1;
+    }
+    return bits;
+}
+
+} // namespace
+
+TYPED_TEST(DynamicBitset, inline_storage) {
+    using bits_t = dynamic_bitset<TypeParam>;
+    static_assert(sizeof(bits_t) == 2 * sizeof(std::size_t) + sizeof(void *),
+                  "Inline buffer should not add to the size");
+
+    bits_t small(8 * sizeof(void *));
+    ASSERT_EQ(small.capacity(), 8 * sizeof(void *));
+    bits_t large(8 * sizeof(void *) + 1);
+    ASSERT_GT(large.capacity(), 8 * sizeof(void *));
+
+    dynamic_bitset<TypeParam, 16> wide(16 * 8 * sizeof(TypeParam));
+    ASSERT_EQ(wide.capacity(), 16 * 8 * sizeof(TypeParam));
+}
+
+TYPED_TEST(DynamicBitset, constructors) {
+    dynamic_bitset<TypeParam> empty;
+    ASSERT_EQ(empty.size(), 0);
+    ASSERT_TRUE(empty.empty());
+    ASSERT_TRUE(empty.none());
+    ASSERT_TRUE(empty.all());
+    ASSERT_EQ(empty.to_string(), "");
+
+    dynamic_bitset<TypeParam> value(12, 0xf0f5);
+    ASSERT_EQ(value.size(), 12);
+    ASSERT_EQ(value.to_ulong(), 0x0f5);
+    ASSERT_EQ(value.to_string(), "000011110101");
+
+    dynamic_bitset<TypeParam> wide(200, ~0ull);
+    ASSERT_EQ(wide.count(), 64);
+    ASSERT_EQ(wide.to_ullong(), ~0ull);
+
+    dynamic_bitset<TypeParam> str(std::string("xx1011"), 2);
+    ASSERT_EQ(str.size(), 4);
+    ASSERT_EQ(str.to_ulong(), 0b1011);
+    dynamic_bitset<TypeParam> chars("ab", 2, 'a', 'b');
+    ASSERT_EQ(chars.to_string(), "01");
+    dynamic_bitset<TypeParam> prefix("110011", 3);
+    ASSERT_EQ(prefix.to_string(), "110");
+
+    ASSERT_THROW(dynamic_bitset<TypeParam>(std::string("012")),
+                 std::invalid_argument);
+    ASSERT_THROW(dynamic_bitset<TypeParam>(std::string("01"), 3),
+                 std::out_of_range);
+}
+
+TYPED_TEST(DynamicBitset, copy_and_move) {
+    for (auto n : kSizes) {
+        const auto bits = make_pattern<dynamic_bitset<TypeParam>>(n);
+        auto copy = bits;
+        ASSERT_EQ(copy, bits);
+
+        auto moved = std::move(copy);
+        ASSERT_EQ(moved, bits);
+        ASSERT_EQ(copy.size(), 0);
+
+        dynamic_bitset<TypeParam> assigned(5);
+        assigned = bits;
+        ASSERT_EQ(assigned, bits);
+        assigned = std::move(moved);
+        ASSERT_EQ(assigned, bits);
+
+        dynamic_bitset<TypeParam> other(3, 0b101);
+        swap(assigned, other);
+        ASSERT_EQ(other, bits);
+        ASSERT_EQ(assigned.to_string(), "101");
+    }
+
+    // Moving a heap-backed bitset hands over its buffer
+    dynamic_bitset<TypeParam> heap(1000);
+    heap.set(999);
+    const auto capacity = heap.capacity();
+    dynamic_bitset<TypeParam> stolen(std::move(heap));
+    ASSERT_EQ(stolen.capacity(), capacity);
+    ASSERT_TRUE(stolen.test(999));
+    ASSERT_LT(heap.capacity(), capacity);
+
+    // The moved-from bitset is left empty on its inline words and usable
+    ASSERT_EQ(heap.size(), 0);
+    heap.push_back(true);
+    heap.resize(20);
+    ASSERT_EQ(heap.count(), 1);
+    ASSERT_TRUE(heap.test(0));
+
+    // A heap-backed bitset assigned an inline one goes back to inline words
+    stolen = std::move(heap);
+    ASSERT_EQ(stolen.size(), 20);
+    ASSERT_EQ(stolen.count(), 1);
+    ASSERT_LT(stolen.capacity(), capacity);
+}
+
+TYPED_TEST(DynamicBitset, resize_push_back_append) {
+    dynamic_bitset<TypeParam> bits;
+    std::vector<bool> expected;
+    for (std::size_t i = 0; i < 300; i++) {
+        const bool value = i % 5 == 0 || i % 11 == 3;
+        bits.push_back(value);
+        expected.push_back(value);
+    }
+    ASSERT_EQ(bits.size(), expected.size());
+    for (std::size_t i = 0; i < expected.size(); i++) {
+        ASSERT_EQ(bits[i], expected[i]) << "i: " << i;
+    }
+
+    bits.resize(310, true);
+    ASSERT_EQ(bits.size(), 310);
+    for (std::size_t i = 300; i < 310; i++) {
+        ASSERT_TRUE(bits[i]) << "i: " << i;
+    }
+    bits.resize(13);
+    ASSERT_EQ(bits.size(), 13);
+    bits.resize(400);
+    ASSERT_EQ(bits.find_next(12), 400);
+    bits.pop_back();
+    ASSERT_EQ(bits.size(), 399);
+
+    dynamic_bitset<TypeParam> lhs(std::string("101"));
+    lhs.append(dynamic_bitset<TypeParam>(std::string("0011")));
+    ASSERT_EQ(lhs.to_string(), "0011101");
+    lhs.append(lhs);
+    ASSERT_EQ(lhs.to_string(), "00111010011101");
+    lhs.append(TypeParam{1});
+    ASSERT_EQ(lhs.size(), 14 + 8 * sizeof(TypeParam));
+    ASSERT_EQ(lhs.count(), 9);
+    ASSERT_TRUE(lhs.test(14));
+
+    for (auto n : kSizes) {
+        for (auto m : {std::size_t{1}, std::size_t{9}, std::size_t{130}}) {
+            auto front = make_pattern<dynamic_bitset<TypeParam>>(n);
+            const auto back = make_pattern<dynamic_bitset<TypeParam>>(m);
+            front.append(back);
+            ASSERT_EQ(front.to_string(), back.to_string() +
+                                             make_pattern<dynamic_bitset<
+                                                 TypeParam>>(n)
+                                                 .to_string());
+        }
+    }
+    dynamic_bitset<TypeParam> empty;
+    ASSERT_THROW(empty.pop_back(), std::out_of_range);
+}
+
+TYPED_TEST(DynamicBitset, element_access) {
+    dynamic_bitset<TypeParam> bits(70);
+    bits.set(3).set(69);
+    bits[10] = true;
+    bits[3].flip();
+    ASSERT_FALSE(bits.test(3));
+    ASSERT_TRUE(bits.test(10));
+    ASSERT_TRUE(~bits[11]);
+    bits.flip(10).reset(69);
+    ASSERT_TRUE(bits.none());
+
+    ASSERT_THROW(bits.set(70), std::out_of_range);
+    ASSERT_THROW(bits.reset(70), std::out_of_range);
+    ASSERT_THROW(bits.flip(70), std::out_of_range);
+    ASSERT_THROW(static_cast<void>(bits.test(70)), std::out_of_range);
+}
+
+TYPED_TEST(DynamicBitset, bulk_operations) {
+    for (auto n : kSizes) {
+        auto bits = make_pattern<dynamic_bitset<TypeParam>>(n);
+        std::size_t expected{0};
+        for (std::size_t i = 0; i < n; i++) {
+            expected += bits[i];
+        }
+        ASSERT_EQ(bits.count(), expected) << "n: " << n;
+        ASSERT_EQ((~bits).count(), n - expected) << "n: " << n;
+        ASSERT_EQ(bits.any(), expected > 0);
+
+        bits.set();
+        ASSERT_EQ(bits.count(), n);
+        ASSERT_TRUE(bits.all());
+        bits.flip();
+        ASSERT_TRUE(bits.none());
+        if (n > 0) {
+            bits.set(n - 1);
+            ASSERT_TRUE(bits.any());
+            ASSERT_EQ(bits.find_first(), n - 1);
+            ASSERT_EQ(bits.find_last(), n - 1);
+            bits.flip();
+            ASSERT_FALSE(bits.all());
+        }
+        bits.reset();
+        ASSERT_TRUE(bits.none());
+    }
+}
+
+TYPED_TEST(DynamicBitset, binary_operations) {
+    for (auto n : kSizes) {
+        dynamic_bitset<TypeParam> evens(n);
+        dynamic_bitset<TypeParam> threes(n);
+        for (std::size_t i = 0; i < n; i++) {
+            evens[i] = i % 2 == 0;
+            threes[i] = i % 3 == 0;
+        }
+        const auto anded = evens & threes;
+        const auto ored = evens | threes;
+        const auto xored = evens ^ threes;
+        for (std::size_t i = 0; i < n; i++) {
+            ASSERT_EQ(anded[i], i % 6 == 0);
+            ASSERT_EQ(ored[i], i % 2 == 0 || i % 3 == 0);
+            ASSERT_EQ(xored[i], (i % 2 == 0) != (i % 3 == 0));
+        }
+        ASSERT_EQ(evens.intersection_count(threes), anded.count());
+        ASSERT_EQ(evens.union_count(threes), ored.count());
+        ASSERT_EQ(evens.hamming_distance(threes), xored.count());
+        ASSERT_EQ(evens.difference_count(threes), (evens & ~threes).count());
+        ASSERT_EQ(evens.intersects(threes), n > 0);
+        ASSERT_TRUE(anded.is_subset_of(evens));
+        ASSERT_TRUE(evens.is_disjoint(~evens));
+    }
+
+    dynamic_bitset<TypeParam> a(10);
+    dynamic_bitset<TypeParam> b(11);
+    ASSERT_THROW(a &= b, std::invalid_argument);
+    ASSERT_THROW(a | b, std::invalid_argument);
+    ASSERT_THROW(static_cast<void>(a.intersects(b)), std::invalid_argument);
+    ASSERT_NE(a, b);
+}
+
+TYPED_TEST(DynamicBitset, shifts) {
+    for (auto n : kSizes) {
+        const auto bits = make_pattern<dynamic_bitset<TypeParam>>(n);
+        for (std::size_t shift : {0, 1, 7, 8, 9, 64, 67, 500, 5000}) {
+            const auto left = bits << shift;
+            const auto right = bits >> shift;
+            for (std::size_t i = 0; i < n; i++) {
+                ASSERT_EQ(left[i], i >= shift && bits[i - shift])
+                    << "n: " << n << ", shift: " << shift << ", i: " << i;
+                ASSERT_EQ(right[i], i + shift < n && bits[i + shift])
+                    << "n: " << n << ", shift: " << shift << ", i: " << i;
+            }
+        }
+    }
+}
+
+TYPED_TEST(DynamicBitset, find_and_set_bits) {
+    for (auto n : kSizes) {
+        const auto bits = make_pattern<dynamic_bitset<TypeParam>>(n);
+        std::vector<std::size_t> expected;
+        for (std::size_t i = 0; i < n; i++) {
+            if (bits[i]) {
+                expected.push_back(i);
+            }
+        }
+        std::vector<std::size_t> found;
+        for (auto pos = bits.find_first(); pos < n;
+             pos = bits.find_next(pos)) {
+            found.push_back(pos);
+        }
+        ASSERT_EQ(found, expected);
+
+        const auto range = bits.set_bits();
+        ASSERT_EQ(std::vector<std::size_t>(range.begin(), range.end()),
+                  expected);
+
+        std::vector<std::size_t> reversed;
+        for (auto pos = bits.find_last(); pos < n; pos = bits.find_prev(pos)) {
+            reversed.insert(reversed.begin(), pos);
+        }
+        ASSERT_EQ(reversed, expected);
+    }
+}
+
+TYPED_TEST(DynamicBitset, conversions) {
+    dynamic_bitset<TypeParam> bits(100, 0x1234);
+    ASSERT_EQ(bits.to_ulong(), 0x1234);
+    ASSERT_EQ(bits.to_ullong(), 0x1234);
+    bits.set(64);
+    ASSERT_THROW(static_cast<void>(bits.to_ullong()), std::overflow_error);
+
+    std::wstring wide = bits.template to_string<wchar_t>(L'.', L'#');
+    ASSERT_EQ(wide.size(), 100);
+    ASSERT_EQ(wide.back(), L'.');
+    ASSERT_EQ(wide[100 - 1 - 2], L'#');
+}
+
+TYPED_TEST(DynamicBitset, streams) {
+    const auto bits = make_pattern<dynamic_bitset<TypeParam>>(77);
+    std::stringstream ss;
+    ss << bits << " 10 1x01";
+    dynamic_bitset<TypeParam> first;
+    dynamic_bitset<TypeParam> second;
+    ss >> first >> second;
+    ASSERT_EQ(first, bits);
+    ASSERT_EQ(second.to_string(), "10");
+    ASSERT_TRUE(ss.good());
+
+    // Like bitset, an invalid character is extracted and sets failbit
+    dynamic_bitset<TypeParam> third;
+    ss >> third;
+    ASSERT_TRUE(ss.fail());
+    ASSERT_EQ(third.to_string(), "1");
+    ss.clear();
+    ss >> third;
+    ASSERT_EQ(third.to_string(), "01");
+    ASSERT_TRUE(ss.eof());
+
+    ss.clear();
+    ss.str("x");
+    ss >> third;
+    ASSERT_TRUE(ss.fail());
+    ASSERT_EQ(third.to_string(), "01");
+}
+
+TYPED_TEST(DynamicBitset, hash) {
+    using bits_t = dynamic_bitset<TypeParam>;
+    const auto a = make_pattern<bits_t>(200);
+    auto b = a;
+    ASSERT_EQ(std::hash<bits_t>()(a), std::hash<bits_t>()(b));
+    b.flip(150);
+    ASSERT_NE(std::hash<bits_t>()(a), std::hash<bits_t>()(b));
+    ASSERT_NE(std::hash<bits_t>()(bits_t(3)), std::hash<bits_t>()(bits_t(4)));
+
+    nonstd::bitset<200, TypeParam> fixed;
+    for (std::size_t i = 0; i < a.size(); i++) {
+        fixed[i] = a[i];
+    }
+    ASSERT_EQ(std::hash<bits_t>()(a), std::hash<decltype(fixed)>()(fixed));
+}
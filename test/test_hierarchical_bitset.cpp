@@ -0,0 +1,182 @@
+#include <hierarchical_bitset.hpp>
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using nonstd::bitset;
+using nonstd::hierarchical_bitset;
+
+template <class T> class HierarchicalBitset : public testing::Test {};
+
+using UnsignedTypes =
+    ::testing::Types<std::uint8_t, std::uint16_t, std::uint32_t, std::uint64_t>;
+TYPED_TEST_SUITE(HierarchicalBitset, UnsignedTypes);
+
+namespace {
+
+// Checks every find function against a plain bitset holding the same bits
+template <class Bits, class Reference>
+void expect_same(const Bits &bits, const Reference &reference) {
+    ASSERT_EQ(bits.bits(), reference);
+    ASSERT_EQ(bits.any(), reference.any());
+    ASSERT_EQ(bits.none(), reference.none());
+    ASSERT_EQ(bits.count(), reference.count());
+    ASSERT_EQ(bits.find_first(), reference.find_first());
+    ASSERT_EQ(bits.find_last(), reference.find_last());
+    for (auto pos = reference.find_first(); pos < reference.size();
+         pos = reference.find_next(pos)) {
+        ASSERT_EQ(bits.find_next(pos), reference.find_next(pos))
+            << "pos: " << pos;
+        ASSERT_EQ(bits.find_prev(pos), reference.find_prev(pos))
+            << "pos: " << pos;
+    }
+}
+
+template <std::size_t N, class Underlying> void random_updates() {
+    using bits_t = hierarchical_bitset<N, Underlying>;
+    auto bits = std::make_unique<bits_t>();
+    auto reference = std::make_unique<bitset<N, Underlying>>();
+    expect_same(*bits, *reference);
+
+    std::mt19937 rng(N);
+    std::uniform_int_distribution<std::size_t> dist(0, N - 1);
+    for (int round = 0; round < 4; round++) {
+        for (int i = 0; i < 40; i++) {
+            const auto pos = dist(rng);
+            switch (rng() % 3) {
+            case 0:
+                bits->set(pos);
+                reference->set(pos);
+                break;
+            case 1:
+                bits->reset(pos);
+                reference->reset(pos);
+                break;
+            default:
+                bits->flip(pos);
+                reference->flip(pos);
+            }
+            ASSERT_EQ((*bits)[pos], (*reference)[pos]);
+        }
+        expect_same(*bits, *reference);
+    }
+
+    // Clearing one bit at a time empties the summaries again
+    for (auto pos = reference->find_first(); pos < N;
+         pos = reference->find_next(pos)) {
+        bits->reset(pos);
+    }
+    ASSERT_TRUE(bits->none());
+    ASSERT_EQ(bits->find_first(), N);
+    ASSERT_EQ(bits->find_last(), N);
+}
+
+} // namespace
+
+TYPED_TEST(HierarchicalBitset, random_updates) {
+    random_updates<1, TypeParam>();
+    random_updates<64, TypeParam>();
+    random_updates<65, TypeParam>();
+    random_updates<4096, TypeParam>();
+    random_updates<4097, TypeParam>();
+    random_updates<300000, TypeParam>();
+}
+
+TYPED_TEST(HierarchicalBitset, sparse_search) {
+    constexpr std::size_t kNumBits = std::size_t{1} << 20;
+    auto bits = std::make_unique<hierarchical_bitset<kNumBits, TypeParam>>();
+    ASSERT_TRUE(bits->none());
+    const std::vector<std::size_t> positions{0, 1, 4095, 4096, 500000,
+                                             kNumBits - 1};
+    for (auto pos : positions) {
+        bits->set(pos);
+    }
+    ASSERT_TRUE(bits->any());
+    ASSERT_EQ(bits->count(), positions.size());
+
+    std::vector<std::size_t> found;
+    for (auto pos = bits->find_first(); pos < kNumBits;
+         pos = bits->find_next(pos)) {
+        found.push_back(pos);
+    }
+    ASSERT_EQ(found, positions);
+
+    found.clear();
+    for (auto pos = bits->find_last(); pos < kNumBits;
+         pos = bits->find_prev(pos)) {
+        found.insert(found.begin(), pos);
+    }
+    ASSERT_EQ(found, positions);
+    ASSERT_EQ(bits->find_next(kNumBits), kNumBits);
+    ASSERT_EQ(bits->find_prev(0), kNumBits);
+}
+
+TYPED_TEST(HierarchicalBitset, whole_bitset_operations) {
+    constexpr std::size_t kNumBits{5000};
+    using bits_t = hierarchical_bitset<kNumBits, TypeParam>;
+    bitset<kNumBits, TypeParam> evens;
+    bitset<kNumBits, TypeParam> tail;
+    for (std::size_t i = 0; i < kNumBits; i++) {
+        evens[i] = i % 2 == 0;
+        tail[i] = i >= 4000;
+    }
+
+    bits_t bits(evens);
+    expect_same(bits, evens);
+    bits &= tail;
+    expect_same(bits, (evens & tail).eval());
+    bits |= tail;
+    expect_same(bits, tail);
+    bits ^= tail;
+    expect_same(bits, bitset<kNumBits, TypeParam>());
+    ASSERT_EQ(bits, bits_t());
+
+    bits.set();
+    ASSERT_TRUE(bits.all());
+    ASSERT_EQ(bits.find_last(), kNumBits - 1);
+    bits.flip();
+    ASSERT_TRUE(bits.none());
+    bits.set(17).reset();
+    ASSERT_TRUE(bits.none());
+    ASSERT_NE(bits, bits_t(tail));
+}
+
+TYPED_TEST(HierarchicalBitset, errors) {
+    hierarchical_bitset<100, TypeParam> bits;
+    ASSERT_THROW(bits.set(100), std::out_of_range);
+    ASSERT_THROW(bits.reset(100), std::out_of_range);
+    ASSERT_THROW(bits.flip(100), std::out_of_range);
+    ASSERT_THROW(static_cast<void>(bits.test(100)), std::out_of_range);
+    ASSERT_FALSE(bits.test(99));
+}
+
+TEST(HierarchicalBitset, default_underlying) {
+    bitset<100> plain;
+    plain.set(42);
+    hierarchical_bitset<100> bits(plain);
+    bits |= bitset<100>{}.set(7);
+    ASSERT_EQ(bits.bits(), bitset<100>{}.set(7).set(42));
+}
+
+TEST(HierarchicalBitset, summary_levels) {
+    // The summaries are 64-ary whatever the word type of the bits
+    static_assert(hierarchical_bitset<64, std::uint64_t>::summary_levels() ==
+                  0);
+    static_assert(hierarchical_bitset<64>::summary_levels() == 1);
+    static_assert(
+        hierarchical_bitset<1 << 24, std::uint64_t>::summary_levels() == 3);
+    static_assert(hierarchical_bitset<1 << 24>::summary_levels() == 4);
+
+    auto bits = std::make_unique<hierarchical_bitset<1 << 24>>();
+    bits->set(5).set(3'000'000).set((1 << 24) - 1);
+    ASSERT_EQ(bits->find_first(), 5);
+    ASSERT_EQ(bits->find_next(5), 3'000'000);
+    ASSERT_EQ(bits->find_next(3'000'000), (1 << 24) - 1);
+    ASSERT_EQ(bits->find_prev(3'000'000), 5);
+    ASSERT_EQ(bits->find_last(), (1 << 24) - 1);
+    bits->reset(3'000'000);
+    ASSERT_EQ(bits->find_next(5), (1 << 24) - 1);
+}
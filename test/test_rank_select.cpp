@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+#include <rank_select.hpp>
+
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using nonstd::bitset;
+using nonstd::rank_select;
+
+template <class T> class RankSelect : public testing::Test {};
+
+using UnsignedTypes =
+    ::testing::Types<std::uint8_t, std::uint16_t, std::uint32_t, std::uint64_t>;
+TYPED_TEST_SUITE(RankSelect, UnsignedTypes);
+
+namespace {
+
+template <class Bits, class Index>
+void expect_consistent(const Bits &bits, const Index &index) {
+    std::vector<std::size_t> positions;
+    for (std::size_t i = 0; i < bits.size(); i++) {
+        ASSERT_EQ(index.rank(i), positions.size()) << "i: " << i;
+        if (bits[i]) {
+            positions.push_back(i);
+        }
+    }
+    ASSERT_EQ(index.rank(bits.size()), positions.size());
+    ASSERT_EQ(index.count(), positions.size());
+    for (std::size_t k = 0; k < positions.size(); k++) {
+        ASSERT_EQ(index.select(k), positions[k]) << "k: " << k;
+    }
+    ASSERT_EQ(index.select(positions.size()), bits.size());
+}
+
+// Dense and sparse stretches, so that blocks and superblocks are both empty
+// and full somewhere
+template <std::size_t N, class Underlying> void check_size() {
+    using bits_t = bitset<N, Underlying>;
+    auto bits = std::make_unique<bits_t>();
+    std::mt19937 rng(N);
+    for (std::size_t i = 0; i < N; i++) {
+        const bool dense = (i / 5000) % 3 == 1;
+        (*bits)[i] = dense ? rng() % 4 != 0 : rng() % 97 == 0;
+    }
+    rank_select<N, Underlying> index(*bits);
+    expect_consistent(*bits, index);
+
+    // Changes at the end only need the tail rebuilt
+    const std::size_t pos = N * 2 / 3;
+    for (std::size_t i = pos; i < N; i += 3) {
+        bits->flip(i);
+    }
+    index.rebuild(pos);
+    expect_consistent(*bits, index);
+
+    bits->set();
+    index.rebuild();
+    expect_consistent(*bits, index);
+    bits->reset();
+    index.rebuild(0);
+    expect_consistent(*bits, index);
+    ASSERT_EQ(index.select(0), N);
+}
+
+} // namespace
+
+TYPED_TEST(RankSelect, rank_and_select) {
+    check_size<1, TypeParam>();
+    check_size<63, TypeParam>();
+    check_size<64, TypeParam>();
+    check_size<65, TypeParam>();
+    check_size<4096, TypeParam>();
+    check_size<4097, TypeParam>();
+    check_size<100000, TypeParam>();
+}
+
+TYPED_TEST(RankSelect, errors) {
+    bitset<100, TypeParam> bits;
+    bits.set(3);
+    const rank_select<100, TypeParam> index(bits);
+    ASSERT_EQ(index.size(), 100);
+    ASSERT_EQ(index.rank(100), 1);
+    ASSERT_THROW(static_cast<void>(index.rank(101)), std::out_of_range);
+    ASSERT_EQ(index.select(1), 100);
+}
@@ -0,0 +1,204 @@
+#include <gtest/gtest.h>
+#include <roaring_bitset.hpp>
+
+#include <memory>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+using nonstd::bitset;
+using nonstd::roaring_bitset;
+
+template <class T> class RoaringBitset : public testing::Test {};
+
+using UnsignedTypes =
+    ::testing::Types<std::uint8_t, std::uint16_t, std::uint32_t, std::uint64_t>;
+TYPED_TEST_SUITE(RoaringBitset, UnsignedTypes);
+
+namespace {
+
+using reference_t = std::set<std::uint32_t>;
+
+void expect_same(const roaring_bitset &bits, const reference_t &reference) {
+    ASSERT_EQ(bits.count(), reference.size());
+    ASSERT_EQ(bits.any(), !reference.empty());
+    std::vector<std::uint32_t> found;
+    for (auto pos = bits.find_first(); pos < bits.size();
+         pos = bits.find_next(pos)) {
+        found.push_back(static_cast<std::uint32_t>(pos));
+    }
+    ASSERT_EQ(found, std::vector<std::uint32_t>(reference.begin(),
+                                                reference.end()));
+    if (!reference.empty()) {
+        ASSERT_EQ(bits.find_last(), *reference.rbegin());
+    }
+}
+
+// A set mixing every container: a sparse chunk (array), a dense chunk
+// (bitmap) and a chunk of long runs, at chunks picked by seed
+reference_t make_values(unsigned seed) {
+    std::mt19937 rng(seed);
+    reference_t values;
+    const std::uint32_t sparse = (rng() % 4) << 16;
+    for (int i = 0; i < 300; i++) {
+        values.insert(sparse + rng() % 65536);
+    }
+    const std::uint32_t dense = (rng() % 4) << 16;
+    for (int i = 0; i < 30000; i++) {
+        values.insert(dense + rng() % 65536);
+    }
+    const std::uint32_t runs = ((rng() % 4) << 16) + rng() % 1000;
+    for (std::uint32_t start = 0; start < 60000; start += 10000) {
+        for (std::uint32_t i = 0; i < 3000; i++) {
+            values.insert(runs + start + i);
+        }
+    }
+    values.insert(0xffffffffu - rng() % 100);
+    return values;
+}
+
+roaring_bitset make_bits(const reference_t &values, bool optimize) {
+    roaring_bitset bits;
+    for (auto value : values) {
+        bits.set(value);
+    }
+    if (optimize) {
+        bits.run_optimize();
+    }
+    return bits;
+}
+
+} // namespace
+
+TEST(RoaringBitset, single_values) {
+    roaring_bitset bits{5, 70000, 0xffffffff};
+    ASSERT_EQ(bits.count(), 3);
+    ASSERT_TRUE(bits.test(70000));
+    ASSERT_FALSE(bits[70001]);
+    bits.reset(70000).flip(6).set(7, false);
+    expect_same(bits, {5, 6, 0xffffffff});
+
+    // Crossing the array limit in both directions
+    reference_t reference{5, 6, 0xffffffff};
+    for (std::uint32_t i = 0; i < 5000; i++) {
+        bits.set(100000 + 3 * i);
+        reference.insert(100000 + 3 * i);
+    }
+    expect_same(bits, reference);
+    for (std::uint32_t i = 0; i < 5000; i += 2) {
+        bits.reset(100000 + 3 * i);
+        reference.erase(100000 + 3 * i);
+    }
+    expect_same(bits, reference);
+
+    ASSERT_THROW(bits.set(std::size_t{1} << 32), std::out_of_range);
+    ASSERT_THROW(static_cast<void>(bits.test(std::size_t{1} << 32)),
+                 std::out_of_range);
+    bits.reset();
+    ASSERT_TRUE(bits.none());
+    ASSERT_EQ(bits.find_first(), bits.size());
+    ASSERT_EQ(bits.find_last(), bits.size());
+}
+
+TEST(RoaringBitset, binary_operations) {
+    for (unsigned seed = 0; seed < 6; seed++) {
+        const auto lhs_values = make_values(seed);
+        const auto rhs_values = make_values(seed + 100);
+        reference_t anded;
+        reference_t ored;
+        reference_t xored;
+        for (auto value : lhs_values) {
+            (rhs_values.count(value) ? anded : xored).insert(value);
+            ored.insert(value);
+        }
+        for (auto value : rhs_values) {
+            if (!lhs_values.count(value)) {
+                xored.insert(value);
+            }
+            ored.insert(value);
+        }
+
+        // Every pairing of containers, with and without runs
+        for (bool lhs_runs : {false, true}) {
+            for (bool rhs_runs : {false, true}) {
+                const auto lhs = make_bits(lhs_values, lhs_runs);
+                const auto rhs = make_bits(rhs_values, rhs_runs);
+                expect_same(lhs & rhs, anded);
+                expect_same(lhs | rhs, ored);
+                expect_same(lhs ^ rhs, xored);
+                ASSERT_EQ(lhs.intersection_count(rhs), anded.size());
+                ASSERT_EQ(lhs.union_count(rhs), ored.size());
+                ASSERT_EQ(lhs.hamming_distance(rhs), xored.size());
+                ASSERT_EQ(lhs.intersects(rhs), !anded.empty());
+
+                auto assigned = lhs;
+                assigned &= rhs;
+                ASSERT_EQ(assigned, lhs & rhs);
+                assigned |= rhs;
+                ASSERT_EQ(assigned, rhs);
+                assigned ^= lhs;
+                ASSERT_EQ(assigned, lhs ^ rhs);
+            }
+        }
+    }
+}
+
+TEST(RoaringBitset, run_optimize) {
+    reference_t range;
+    for (std::uint32_t i = 1000; i < 200000; i++) {
+        range.insert(i);
+    }
+    auto bits = make_bits(range, false);
+    const auto dense_bytes = bits.size_in_bytes();
+    ASSERT_TRUE(bits.run_optimize());
+    ASSERT_LT(bits.size_in_bytes(), dense_bytes / 100);
+    ASSERT_EQ(bits, make_bits(range, false));
+    expect_same(bits, range);
+
+    // Updates expand the runs again
+    bits.reset(150000);
+    ASSERT_FALSE(bits.test(150000));
+    ASSERT_EQ(bits.count(), 198999);
+
+    roaring_bitset scattered;
+    for (std::size_t i = 0; i < 1000; i++) {
+        scattered.set(i * 7);
+    }
+    ASSERT_FALSE(scattered.run_optimize());
+}
+
+TYPED_TEST(RoaringBitset, dense_conversion) {
+    constexpr std::size_t kNumBits{200000};
+    using dense_t = bitset<kNumBits, TypeParam>;
+    auto dense = std::make_unique<dense_t>();
+    reference_t reference;
+    for (std::uint32_t i = 0; i < kNumBits; i++) {
+        if (i % 1000 == 7 || (i >= 70000 && i < 120000 && i % 3 != 0) ||
+            i == kNumBits - 1) {
+            dense->set(i);
+            reference.insert(i);
+        }
+    }
+
+    const roaring_bitset bits(*dense);
+    expect_same(bits, reference);
+    ASSERT_EQ((bits.template to_bitset<kNumBits, TypeParam>()), *dense);
+    ASSERT_THROW((bits.template to_bitset<kNumBits - 1, TypeParam>()),
+                 std::out_of_range);
+
+    auto optimized = bits;
+    optimized.set(kNumBits - 2).run_optimize();
+    dense->set(kNumBits - 2);
+    ASSERT_EQ((optimized.template to_bitset<kNumBits, TypeParam>()), *dense);
+    ASSERT_TRUE(roaring_bitset(dense_t()).none());
+}
+
+TEST(RoaringBitset, memory) {
+    // A handful of values in a large universe costs a few bytes each
+    roaring_bitset bits;
+    for (std::size_t i = 0; i < 16; i++) {
+        bits.set(i * 1000000);
+    }
+    ASSERT_LT(bits.size_in_bytes(), 1024);
+}